@@ -0,0 +1,107 @@
+#include "messages/LimitedQueue.hpp"
+#include "messages/Message.hpp"
+#include "widgets/helper/PopMessagesUpTo.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace chatterino;
+
+namespace {
+
+// Stands in for MessageLayout, which holds on to its message
+struct FakeLayout {
+    MessagePtr message;
+
+    const MessagePtr &getMessagePtr() const
+    {
+        return this->message;
+    }
+};
+
+// The default size of a ChannelView's layout buffer
+constexpr size_t viewLimit = 1000;
+
+}  // namespace
+
+// Simulates a day of chat in 100 channels that also feed /mentions and reports
+// how many of the mentions are still alive at the end. The limit of /mentions
+// is the benchmark's argument. A view on /mentions drops a message's layout
+// when /mentions drops the message, like ChannelView::dropMessagesUpTo.
+static void BM_AggregateChannel_Retained24h(benchmark::State &state)
+{
+    constexpr size_t channelCount = 100;
+    constexpr size_t channelLimit = 1000;
+    constexpr size_t messagesPerSecond = 5;
+    constexpr size_t seconds = 24 * 60 * 60;
+    // One in 200 messages is a mention
+    constexpr size_t mentionRatio = 200;
+
+    for (auto _ : state)
+    {
+        std::vector<std::unique_ptr<LimitedQueue<MessagePtr>>> channels;
+        for (size_t i = 0; i < channelCount; ++i)
+        {
+            channels.push_back(
+                std::make_unique<LimitedQueue<MessagePtr>>(channelLimit));
+        }
+        LimitedQueue<MessagePtr> mentions(size_t(state.range(0)));
+        LimitedQueue<std::shared_ptr<FakeLayout>> view(viewLimit);
+        LimitedQueue<MessagePtr> hidden(viewLimit);
+        std::vector<std::weak_ptr<const Message>> mentionRefs;
+
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<size_t> pickChannel(0,
+                                                          channelCount - 1);
+
+        for (size_t i = 0; i < seconds * messagesPerSecond; ++i)
+        {
+            auto message = std::make_shared<Message>();
+            channels[pickChannel(rng)]->pushBack(message);
+
+            if (i % mentionRatio == 0)
+            {
+                MessagePtr dropped;
+                if (mentions.pushBack(message, dropped))
+                {
+                    popMessagesUpTo(view, hidden, dropped);
+                }
+                view.pushBack(
+                    std::make_shared<FakeLayout>(FakeLayout{message}));
+                mentionRefs.push_back(message);
+            }
+        }
+
+        size_t retained = 0;
+        size_t retainedByHome = 0;
+        for (const auto &ref : mentionRefs)
+        {
+            if (auto message = ref.lock())
+            {
+                retained++;
+                // use_count includes `message`, /mentions, its view and the
+                // home channel
+                if (message.use_count() > 3)
+                {
+                    retainedByHome++;
+                }
+            }
+        }
+
+        state.counters["mentions"] = double(mentionRefs.size());
+        state.counters["retained"] = double(retained);
+        state.counters["retained only by /mentions and its view"] =
+            double(retained - retainedByHome);
+        state.counters["retained bytes (approx.)"] =
+            double(retained * sizeof(Message));
+    }
+}
+
+BENCHMARK(BM_AggregateChannel_Retained24h)
+    ->Arg(500)
+    ->Arg(1000)
+    ->Iterations(1)
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,126 @@
+#include "widgets/helper/ChannelViewRegistry.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+using namespace chatterino;
+
+namespace {
+
+constexpr int VIEW_COUNT = 200;
+constexpr int CHANNEL_COUNT = 50;
+// One in four views is visible, the rest are in background tabs
+constexpr int VISIBLE_RATIO = 4;
+
+struct FakeView {
+    const Channel *channel = nullptr;
+    bool visible = false;
+    bool layoutQueuedWhileHidden = false;
+    int layouts = 0;
+
+    void queueLayout()
+    {
+        if (!this->visible)
+        {
+            this->layoutQueuedWhileHidden = true;
+            return;
+        }
+        this->layouts++;
+    }
+};
+
+const Channel *channel(int i)
+{
+    static char channels[CHANNEL_COUNT];
+    return reinterpret_cast<const Channel *>(&channels[i]);
+}
+
+std::vector<FakeView> makeViews()
+{
+    std::vector<FakeView> views(VIEW_COUNT);
+    for (int i = 0; i < VIEW_COUNT; ++i)
+    {
+        views[i].channel = channel(i % CHANNEL_COUNT);
+        views[i].visible = i % VISIBLE_RATIO == 0;
+    }
+    return views;
+}
+
+// Every view receives every request and checks the channel itself
+void broadcast(std::vector<FakeView> &views, const Channel *channel)
+{
+    for (auto &view : views)
+    {
+        if (view.visible && (channel == nullptr || view.channel == channel))
+        {
+            view.queueLayout();
+        }
+    }
+}
+
+}  // namespace
+
+static void BM_ChannelViewRegistry_BroadcastChannel200(benchmark::State &state)
+{
+    auto views = makeViews();
+    int i = 0;
+
+    for (auto _ : state)
+    {
+        broadcast(views, channel(i++ % CHANNEL_COUNT));
+    }
+}
+
+BENCHMARK(BM_ChannelViewRegistry_BroadcastChannel200);
+
+static void BM_ChannelViewRegistry_TargetedChannel200(benchmark::State &state)
+{
+    auto views = makeViews();
+    ChannelViewRegistry<FakeView> registry;
+    for (auto &view : views)
+    {
+        registry.add(&view);
+        registry.setChannel(&view, view.channel);
+        registry.setVisible(&view, view.visible);
+    }
+    int i = 0;
+
+    for (auto _ : state)
+    {
+        registry.requestLayout(channel(i++ % CHANNEL_COUNT));
+    }
+}
+
+BENCHMARK(BM_ChannelViewRegistry_TargetedChannel200);
+
+static void BM_ChannelViewRegistry_BroadcastAll200(benchmark::State &state)
+{
+    auto views = makeViews();
+
+    for (auto _ : state)
+    {
+        broadcast(views, nullptr);
+    }
+}
+
+BENCHMARK(BM_ChannelViewRegistry_BroadcastAll200);
+
+static void BM_ChannelViewRegistry_TargetedAll200(benchmark::State &state)
+{
+    auto views = makeViews();
+    ChannelViewRegistry<FakeView> registry;
+    for (auto &view : views)
+    {
+        registry.add(&view);
+        registry.setChannel(&view, view.channel);
+        registry.setVisible(&view, view.visible);
+    }
+
+    for (auto _ : state)
+    {
+        registry.requestLayout(nullptr);
+    }
+}
+
+BENCHMARK(BM_ChannelViewRegistry_TargetedAll200);
@@ -0,0 +1,95 @@
+#include "common/ChatterSet.hpp"
+
+#include <benchmark/benchmark.h>
+#include <QString>
+
+#include <unordered_set>
+
+using namespace chatterino;
+
+namespace {
+
+std::unordered_set<QString> makeChatters(int count)
+{
+    std::unordered_set<QString> chatters;
+    chatters.reserve(count);
+    for (int i = 0; i < count; ++i)
+    {
+        chatters.insert(QString("chatter_%1").arg(i));
+    }
+    return chatters;
+}
+
+void fill(ChatterSet &set)
+{
+    for (size_t i = 0; i < ChatterSet::chatterLimit; ++i)
+    {
+        set.addRecentChatter(QString("Chatter_%1").arg(i));
+    }
+}
+
+}  // namespace
+
+// Helix chatter list of 100k users while the set is full of recent chatters
+static void BM_ChatterSet_UpdateOnlineChatters(benchmark::State &state)
+{
+    auto online = makeChatters(100000);
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        ChatterSet set;
+        fill(set);
+        state.ResumeTiming();
+
+        set.updateOnlineChatters(online);
+    }
+}
+
+BENCHMARK(BM_ChatterSet_UpdateOnlineChatters);
+
+static void BM_ChatterSet_AddRecentChatter(benchmark::State &state)
+{
+    ChatterSet set;
+    int i = 0;
+
+    for (auto _ : state)
+    {
+        set.addRecentChatter(QString("Chatter_%1").arg(i++ % 100000));
+    }
+}
+
+BENCHMARK(BM_ChatterSet_AddRecentChatter);
+
+static void BM_ChatterSet_Contains(benchmark::State &state)
+{
+    ChatterSet set;
+    fill(set);
+
+    const QString present("CHATTER_1000");
+    const QString missing("NotAChatter");
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(set.contains(present));
+        benchmark::DoNotOptimize(set.contains(missing));
+    }
+}
+
+BENCHMARK(BM_ChatterSet_Contains);
+
+static void BM_ChatterSet_FilterByPrefix(benchmark::State &state)
+{
+    ChatterSet set;
+    fill(set);
+
+    // matches chatter_1999 and chatter_19xx
+    const QString prefix("chatter_19");
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(set.filterByPrefix(prefix));
+    }
+}
+
+BENCHMARK(BM_ChatterSet_FilterByPrefix);
@@ -0,0 +1,66 @@
+#include "common/EmoteCompletionTable.hpp"
+
+#include <benchmark/benchmark.h>
+#include <QString>
+
+#include <iterator>
+#include <random>
+
+using namespace chatterino;
+
+namespace {
+
+// Fills the table with `count` random emote-like names
+void fillTable(EmoteCompletionTable &table, int count)
+{
+    static const QString syllables[] = {"pepe", "Kappa", "kek", "W", "LUL",
+                                        "cat",  "JAM",   "Pog", "monka",
+                                        "Sad",  "Hype",  "xd"};
+    std::mt19937 rng(1337);
+    std::uniform_int_distribution<size_t> pick(0, std::size(syllables) - 1);
+    std::uniform_int_distribution<int> length(1, 3);
+
+    for (int i = 0; i < count; ++i)
+    {
+        QString name;
+        for (int j = length(rng); j > 0; --j)
+        {
+            name += syllables[pick(rng)];
+        }
+        name += QString::number(i % 100);
+        table.add(nullptr, name, "Benchmark");
+    }
+}
+
+}  // namespace
+
+// Queries of one to five characters against 20k candidates, like typing out
+// an emote name
+static void BM_EmoteCompletion_Query20k(benchmark::State &state)
+{
+    EmoteCompletionTable table;
+    fillTable(table, 20000);
+
+    const QString queries[] = {"p", "pe", "pep", "pepe", "pepek"};
+    size_t i = 0;
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(
+            table.query(queries[i++ % std::size(queries)], 200));
+    }
+}
+
+BENCHMARK(BM_EmoteCompletion_Query20k)->Unit(benchmark::kMicrosecond);
+
+static void BM_EmoteCompletion_Build20k(benchmark::State &state)
+{
+    for (auto _ : state)
+    {
+        EmoteCompletionTable table;
+        fillTable(table, 20000);
+        benchmark::DoNotOptimize(table.size());
+    }
+}
+
+BENCHMARK(BM_EmoteCompletion_Build20k)->Unit(benchmark::kMillisecond);
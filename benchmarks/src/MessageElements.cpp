@@ -0,0 +1,124 @@
+#include "messages/Emote.hpp"
+#include "messages/Message.hpp"
+#include "messages/MessageBuilder.hpp"
+#include "messages/MessageElement.hpp"
+#include "singletons/Settings.hpp"
+
+#include <benchmark/benchmark.h>
+#include <QTime>
+
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+using namespace chatterino;
+
+namespace {
+
+constexpr int MESSAGE_COUNT = 10000;
+// Five messages per second
+constexpr int MESSAGE_INTERVAL_MS = 200;
+
+std::vector<EmotePtr> makeBadges()
+{
+    std::vector<EmotePtr> badges;
+    for (const auto *name : {"moderator", "subscriber", "vip", "premium"})
+    {
+        badges.push_back(std::make_shared<Emote>(
+            Emote{EmoteName{name}, ImageSet{}, Tooltip{name}, Url{}}));
+    }
+    return badges;
+}
+
+// Reports the number of distinct elements per message
+void countElements(benchmark::State &state,
+                   const std::vector<MessagePtr> &messages)
+{
+    std::unordered_set<const MessageElement *> elements;
+    for (const auto &message : messages)
+    {
+        for (const auto &element : message->elements)
+        {
+            elements.insert(element.get());
+        }
+    }
+
+    state.counters["elements/message"] =
+        double(elements.size()) / double(messages.size());
+}
+
+}  // namespace
+
+// Builds messages with a timestamp, moderation buttons and two badges that
+// each own their elements. Like before the elements were shared, every
+// timestamp is formatted when it's created.
+static void BM_MessageElements_Owned(benchmark::State &state)
+{
+    Settings settings("/tmp/c2-mock");
+    auto badges = makeBadges();
+    std::vector<MessagePtr> messages;
+    std::vector<std::unique_ptr<TextElement>> formattedTimestamps;
+
+    for (auto _ : state)
+    {
+        messages.clear();
+        formattedTimestamps.clear();
+        for (int i = 0; i < MESSAGE_COUNT; ++i)
+        {
+            MessageBuilder builder;
+            auto time =
+                QTime::fromMSecsSinceStartOfDay(i * MESSAGE_INTERVAL_MS);
+            auto *timestamp = builder.emplace<TimestampElement>(time);
+            formattedTimestamps.emplace_back(timestamp->formatTime(time));
+            builder.emplace<TwitchModerationElement>();
+            for (int j = 0; j < 2; ++j)
+            {
+                const auto &badge = badges[(i + j) % badges.size()];
+                builder
+                    .emplace<BadgeElement>(badge,
+                                           MessageElementFlag::BadgeVanity)
+                    ->setTooltip(badge->tooltip.string);
+            }
+            builder.emplace<TextElement>("hello", MessageElementFlag::Text);
+            messages.push_back(builder.release());
+        }
+    }
+
+    countElements(state, messages);
+}
+
+BENCHMARK(BM_MessageElements_Owned)->Unit(benchmark::kMillisecond);
+
+// Same as above with the shared elements. Shared timestamps are formatted
+// once they're laid out, which isn't part of this benchmark.
+static void BM_MessageElements_Shared(benchmark::State &state)
+{
+    Settings settings("/tmp/c2-mock");
+    auto badges = makeBadges();
+    std::vector<MessagePtr> messages;
+
+    for (auto _ : state)
+    {
+        messages.clear();
+        for (int i = 0; i < MESSAGE_COUNT; ++i)
+        {
+            MessageBuilder builder;
+            builder.appendTimestamp(
+                QTime::fromMSecsSinceStartOfDay(i * MESSAGE_INTERVAL_MS));
+            builder.append(TwitchModerationElement::instance());
+            for (int j = 0; j < 2; ++j)
+            {
+                const auto &badge = badges[(i + j) % badges.size()];
+                builder.append(BadgeElement::interned<BadgeElement>(
+                    badge, MessageElementFlag::BadgeVanity,
+                    badge->tooltip.string));
+            }
+            builder.emplace<TextElement>("hello", MessageElementFlag::Text);
+            messages.push_back(builder.release());
+        }
+    }
+
+    countElements(state, messages);
+}
+
+BENCHMARK(BM_MessageElements_Shared)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,141 @@
+#include "messages/layouts/MessageLayoutContainer.hpp"
+
+#include "messages/layouts/MessageLayoutElement.hpp"
+#include "messages/MessageElement.hpp"
+#include "singletons/Settings.hpp"
+
+#include <benchmark/benchmark.h>
+#include <QPoint>
+#include <QSize>
+
+#include <random>
+#include <vector>
+
+using namespace chatterino;
+
+namespace {
+
+constexpr int ELEMENT_WIDTH = 28;
+constexpr int ELEMENT_HEIGHT = 28;
+constexpr int ELEMENTS_PER_LINE = 20;
+// Elements are followed by a 4px space
+constexpr int LINE_WIDTH = ELEMENTS_PER_LINE * (ELEMENT_WIDTH + 4);
+
+// Lays out `lines` lines of emote-sized elements
+void fillContainer(MessageLayoutContainer &container, MessageElement &creator,
+                   int lines)
+{
+    for (int line = 0; line < lines; ++line)
+    {
+        for (int i = 0; i < ELEMENTS_PER_LINE; ++i)
+        {
+            container.addElementNoLineBreak(new ImageLayoutElement(
+                creator, nullptr, QSize(ELEMENT_WIDTH, ELEMENT_HEIGHT)));
+        }
+        container.breakLine();
+    }
+    container.end();
+}
+
+std::vector<QPoint> randomPoints(const MessageLayoutContainer &container,
+                                 size_t count)
+{
+    std::mt19937 rng(1337);
+    std::uniform_int_distribution<int> x(0, LINE_WIDTH);
+    std::uniform_int_distribution<int> y(0, container.getHeight());
+
+    std::vector<QPoint> points;
+    points.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        points.emplace_back(x(rng), y(rng));
+    }
+    return points;
+}
+
+}  // namespace
+
+static void BM_MessageLayoutContainer_GetElementAt(benchmark::State &state)
+{
+    Settings settings("/tmp/c2-mock");
+    EmptyElement creator;
+    MessageLayoutContainer container;
+
+    fillContainer(container, creator, int(state.range(0)));
+
+    auto points = randomPoints(container, 1024);
+    size_t i = 0;
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(
+            container.getElementAt(points[i++ % points.size()]));
+    }
+}
+
+BENCHMARK(BM_MessageLayoutContainer_GetElementAt)->Range(1, 256);
+
+static void BM_MessageLayoutContainer_GetSelectionIndex(
+    benchmark::State &state)
+{
+    Settings settings("/tmp/c2-mock");
+    EmptyElement creator;
+    MessageLayoutContainer container;
+
+    fillContainer(container, creator, int(state.range(0)));
+
+    auto points = randomPoints(container, 1024);
+    size_t i = 0;
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(
+            container.getSelectionIndex(points[i++ % points.size()]));
+    }
+}
+
+BENCHMARK(BM_MessageLayoutContainer_GetSelectionIndex)->Range(1, 256);
+
+static void BM_MessageLayoutContainer_Layout10k(benchmark::State &state)
+{
+    Settings settings("/tmp/c2-mock");
+    EmptyElement creator;
+
+    for (auto _ : state)
+    {
+        std::vector<MessageLayoutContainer> containers(10000);
+        for (auto &container : containers)
+        {
+            fillContainer(container, creator, 3);
+        }
+        benchmark::DoNotOptimize(containers.data());
+    }
+}
+
+BENCHMARK(BM_MessageLayoutContainer_Layout10k)->Unit(benchmark::kMillisecond);
+
+static void BM_MessageLayoutContainer_HitTest10k(benchmark::State &state)
+{
+    Settings settings("/tmp/c2-mock");
+    EmptyElement creator;
+
+    std::vector<MessageLayoutContainer> containers(10000);
+    for (auto &container : containers)
+    {
+        fillContainer(container, creator, 3);
+    }
+
+    auto points = randomPoints(containers.front(), 1024);
+    size_t i = 0;
+
+    for (auto _ : state)
+    {
+        auto &container = containers[(i * 7919) % containers.size()];
+        const auto &point = points[i % points.size()];
+        benchmark::DoNotOptimize(container.getElementAt(point));
+        benchmark::DoNotOptimize(container.getSelectionIndex(point));
+        ++i;
+    }
+}
+
+BENCHMARK(BM_MessageLayoutContainer_HitTest10k);
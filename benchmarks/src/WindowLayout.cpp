@@ -0,0 +1,76 @@
+#include "common/WindowDescriptors.hpp"
+#include "widgets/Window.hpp"
+
+#include <benchmark/benchmark.h>
+#include <QCryptographicHash>
+#include <QJsonDocument>
+#include <QUuid>
+
+using namespace chatterino;
+
+namespace {
+
+// Builds a main window with `tabs` tabs of `splitsPerTab` splits each
+WindowLayout makeLayout(int tabs, int splitsPerTab)
+{
+    WindowLayout layout;
+
+    WindowDescriptor window;
+    window.type_ = WindowType::Main;
+    window.geometry_ = QRect(0, 0, 1280, 720);
+
+    for (int tabIndex = 0; tabIndex < tabs; ++tabIndex)
+    {
+        TabDescriptor tab;
+        tab.customTitle_ = QString("tab %1").arg(tabIndex);
+        tab.selected_ = tabIndex == 0;
+
+        ContainerNodeDescriptor container;
+        for (int splitIndex = 0; splitIndex < splitsPerTab; ++splitIndex)
+        {
+            SplitNodeDescriptor split;
+            split.type_ = "twitch";
+            split.channelName_ =
+                QString("channel_%1_%2").arg(tabIndex).arg(splitIndex);
+            split.filters_.append(QUuid::createUuid());
+            container.items_.emplace_back(std::move(split));
+        }
+        tab.rootNode_ = std::move(container);
+
+        window.tabs_.push_back(std::move(tab));
+    }
+
+    layout.windows_.push_back(std::move(window));
+    return layout;
+}
+
+}  // namespace
+
+// Serializing and hashing happen on a worker thread when the layout is saved
+static void BM_WindowLayout_Serialize200(benchmark::State &state)
+{
+    auto layout = makeLayout(20, 10);
+
+    for (auto _ : state)
+    {
+        auto data = layout.toJSON().toJson();
+        benchmark::DoNotOptimize(
+            QCryptographicHash::hash(data, QCryptographicHash::Sha1));
+    }
+}
+
+BENCHMARK(BM_WindowLayout_Serialize200);
+
+// Copying a layout is what the GUI thread hands to the worker thread
+static void BM_WindowLayout_Copy200(benchmark::State &state)
+{
+    auto layout = makeLayout(20, 10);
+
+    for (auto _ : state)
+    {
+        WindowLayout copy = layout;
+        benchmark::DoNotOptimize(copy.windows_.data());
+    }
+}
+
+BENCHMARK(BM_WindowLayout_Copy200);
@@ -131,9 +131,10 @@ void Application::initialize(Settings &settings, Paths &paths)
         {
             if (auto container = dynamic_cast<SplitContainer *>(selected))
             {
-                for (auto &&split : container->getSplits())
+                // The window isn't shown yet, so its splits may not exist
+                for (auto &&channel : container->getChannels())
                 {
-                    if (auto channel = split->getChannel(); !channel->isEmpty())
+                    if (!channel->isEmpty())
                     {
                         channel->addMessage(makeSystemMessage(
                             "Chatterino unexpectedly crashed and restarted. "
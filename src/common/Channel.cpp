@@ -24,10 +24,12 @@ namespace chatterino {
 //
 // Channel
 //
-Channel::Channel(const QString &name, Type type)
+Channel::Channel(const QString &name, Type type, size_t messageLimit)
     : completionModel(*this)
     , lastDate_(QDate::currentDate())
     , name_(name)
+    , messageLimit_(messageLimit)
+    , messages_(messageLimit)
     , type_(type)
 {
 }
@@ -77,6 +79,11 @@ LimitedQueueSnapshot<MessagePtr> Channel::getMessageSnapshot()
     return this->messages_.getSnapshot();
 }
 
+size_t Channel::getMessageLimit() const
+{
+    return this->messageLimit_;
+}
+
 void Channel::addMessage(MessagePtr message,
                          boost::optional<MessageFlags> overridingFlags)
 {
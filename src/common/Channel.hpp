@@ -30,6 +30,8 @@ enum class TimeoutStackStyle : int {
 class Channel : public std::enable_shared_from_this<Channel>
 {
 public:
+    static constexpr size_t DEFAULT_MESSAGE_LIMIT = 1000;
+
     enum class Type {
         None,
         Direct,
@@ -43,7 +45,8 @@ public:
         Misc
     };
 
-    explicit Channel(const QString &name, Type type);
+    explicit Channel(const QString &name, Type type,
+                     size_t messageLimit = DEFAULT_MESSAGE_LIMIT);
     virtual ~Channel();
 
     // SIGNALS
@@ -71,6 +74,8 @@ public:
     bool isTwitchChannel() const;
     virtual bool isEmpty() const;
     LimitedQueueSnapshot<MessagePtr> getMessageSnapshot();
+    // Maximum number of messages kept by this channel
+    size_t getMessageLimit() const;
 
     // MESSAGES
     // overridingFlags can be filled in with flags that should be used instead
@@ -117,6 +122,7 @@ protected:
 
 private:
     const QString name_;
+    const size_t messageLimit_;
     LimitedQueue<MessagePtr> messages_;
     Type type_;
     QTimer clearCompletionModelTimer_;
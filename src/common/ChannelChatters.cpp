@@ -80,6 +80,25 @@ void ChannelChatters::updateOnlineChatters(
     chatters->updateOnlineChatters(usernames);
 }
 
+void ChannelChatters::beginOnlineChattersUpdate()
+{
+    auto chatters = this->chatters_.access();
+    chatters->beginOnlineChattersUpdate();
+}
+
+void ChannelChatters::addOnlineChatters(
+    const std::unordered_set<QString> &usernames)
+{
+    auto chatters = this->chatters_.access();
+    chatters->addOnlineChatters(usernames);
+}
+
+void ChannelChatters::finishOnlineChattersUpdate()
+{
+    auto chatters = this->chatters_.access();
+    chatters->finishOnlineChattersUpdate();
+}
+
 size_t ChannelChatters::colorsSize() const
 {
     auto size = this->chatterColors_.access()->size();
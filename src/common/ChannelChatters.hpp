@@ -24,6 +24,10 @@ public:
     const QColor getUserColor(const QString &user);
     void setUserColor(const QString &user, const QColor &color);
     void updateOnlineChatters(const std::unordered_set<QString> &usernames);
+    // Paginated variant of updateOnlineChatters, see ChatterSet
+    void beginOnlineChattersUpdate();
+    void addOnlineChatters(const std::unordered_set<QString> &usernames);
+    void finishOnlineChattersUpdate();
 
     // colorsSize returns the amount of colors stored in `chatterColors_`
     // NOTE: This function is only meant to be used in tests and benchmarks
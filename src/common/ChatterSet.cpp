@@ -2,18 +2,55 @@
 
 #include "debug/Benchmark.hpp"
 
-#include <tuple>
+#include <algorithm>
+#include <iterator>
 
 namespace chatterino {
 
 ChatterSet::ChatterSet()
-    : items(chatterLimit)
 {
+    this->items_.reserve(chatterLimit);
+}
+
+size_t ChatterSet::CaseInsensitiveHash::operator()(const QString &string) const
+{
+    // Must agree with QString::compare(..., Qt::CaseInsensitive), which
+    // compares case folded characters
+    size_t hash = 0;
+    for (auto c : string)
+    {
+        hash = hash * 31 + c.toCaseFolded().unicode();
+    }
+    return hash;
 }
 
 void ChatterSet::addRecentChatter(const QString &userName)
 {
-    this->items.put(userName.toLower(), userName);
+    auto it = this->items_.find(userName);
+    if (it != this->items_.end())
+    {
+        // Bump the chatter to the front
+        this->recentChatters_.splice(this->recentChatters_.begin(),
+                                     this->recentChatters_,
+                                     it->second.recency);
+        it->second.userName = userName;
+        it->second.lastSeen = ++this->lastSeenCounter_;
+        it->second.onlineGeneration = this->onlineGeneration_;
+        return;
+    }
+
+    auto lowerCaseUserName = userName.toLower();
+    this->recentChatters_.push_front(lowerCaseUserName);
+    this->items_.emplace(lowerCaseUserName,
+                         Chatter{userName, ++this->lastSeenCounter_,
+                                 this->onlineGeneration_,
+                                 this->recentChatters_.begin()});
+    this->sortedNames_.insert(lowerCaseUserName);
+
+    if (this->items_.size() > chatterLimit)
+    {
+        this->remove(this->items_.find(this->recentChatters_.back()));
+    }
 }
 
 void ChatterSet::updateOnlineChatters(
@@ -21,39 +58,128 @@ void ChatterSet::updateOnlineChatters(
 {
     BenchmarkGuard bench("update online chatters");
 
-    // Create a new lru cache without the users that are not present anymore.
-    cache::lru_cache<QString, QString> tmp(chatterLimit);
+    // Remove the users that are not present anymore.
+    for (auto it = this->recentChatters_.begin();
+         it != this->recentChatters_.end();)
+    {
+        const auto &name = *it++;
+        if (lowerCaseUsernames.count(name) == 0)
+        {
+            this->remove(this->items_.find(name));
+        }
+    }
+
+    // Less chatters than the limit => try to preserve as many as possible.
+    if (lowerCaseUsernames.size() >= chatterLimit)
+    {
+        return;
+    }
 
-    for (auto &&chatter : lowerCaseUsernames)
+    for (const auto &chatter : lowerCaseUsernames)
     {
-        if (this->items.exists(chatter))
-            tmp.put(chatter, this->items.get(chatter));
+        if (this->items_.count(chatter) != 0)
+        {
+            continue;
+        }
 
-        // Less chatters than the limit => try to preserve as many as possible.
-        else if (lowerCaseUsernames.size() < chatterLimit)
-            tmp.put(chatter, chatter);
+        // Online chatters that didn't write anything are the least recent
+        this->recentChatters_.push_back(chatter);
+        this->items_.emplace(chatter,
+                             Chatter{chatter, 0, this->onlineGeneration_,
+                                     std::prev(this->recentChatters_.end())});
+        this->sortedNames_.insert(chatter);
     }
+}
 
-    this->items = std::move(tmp);
+void ChatterSet::beginOnlineChattersUpdate()
+{
+    this->onlineGeneration_++;
+}
+
+void ChatterSet::addOnlineChatters(
+    const std::unordered_set<QString> &lowerCaseUsernames)
+{
+    for (const auto &chatter : lowerCaseUsernames)
+    {
+        auto it = this->items_.find(chatter);
+        if (it != this->items_.end())
+        {
+            it->second.onlineGeneration = this->onlineGeneration_;
+            continue;
+        }
+
+        // Never push out chatters for users that only showed up in the list
+        if (this->items_.size() >= chatterLimit)
+        {
+            continue;
+        }
+
+        this->recentChatters_.push_back(chatter);
+        this->items_.emplace(chatter,
+                             Chatter{chatter, 0, this->onlineGeneration_,
+                                     std::prev(this->recentChatters_.end())});
+        this->sortedNames_.insert(chatter);
+    }
+}
+
+void ChatterSet::finishOnlineChattersUpdate()
+{
+    BenchmarkGuard bench("finish online chatters update");
+
+    for (auto it = this->recentChatters_.begin();
+         it != this->recentChatters_.end();)
+    {
+        auto chatter = this->items_.find(*it++);
+        if (chatter->second.onlineGeneration != this->onlineGeneration_)
+        {
+            this->remove(chatter);
+        }
+    }
 }
 
 bool ChatterSet::contains(const QString &userName) const
 {
-    return this->items.exists(userName.toLower());
+    return this->items_.count(userName) != 0;
 }
 
 std::vector<QString> ChatterSet::filterByPrefix(const QString &prefix) const
 {
-    QString lowerPrefix = prefix.toLower();
-    std::vector<QString> result;
+    // All names starting with the prefix are a contiguous range
+    std::vector<const Chatter *> matches;
+    for (auto it = this->sortedNames_.lower_bound(prefix);
+         it != this->sortedNames_.end() &&
+         it->startsWith(prefix, Qt::CaseInsensitive);
+         ++it)
+    {
+        matches.push_back(&this->items_.find(*it)->second);
+    }
+
+    std::sort(matches.begin(), matches.end(), [](auto *a, auto *b) {
+        return a->lastSeen > b->lastSeen;
+    });
 
-    for (auto &&item : this->items)
+    std::vector<QString> result;
+    result.reserve(matches.size());
+    for (const auto *chatter : matches)
     {
-        if (item.first.startsWith(lowerPrefix))
-            result.push_back(item.second);
+        result.push_back(chatter->userName);
     }
 
     return result;
 }
 
+size_t ChatterSet::size() const
+{
+    return this->items_.size();
+}
+
+void ChatterSet::remove(
+    std::unordered_map<QString, Chatter, CaseInsensitiveHash,
+                       CaseInsensitiveEqual>::iterator it)
+{
+    this->sortedNames_.erase(it->first);
+    this->recentChatters_.erase(it->second.recency);
+    this->items_.erase(it);
+}
+
 }  // namespace chatterino
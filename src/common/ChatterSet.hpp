@@ -2,10 +2,11 @@
 
 #include "util/QStringHash.hpp"
 
-#include <lrucache/lrucache.hpp>
 #include <QString>
 
+#include <cstdint>
 #include <functional>
+#include <list>
 #include <set>
 #include <unordered_map>
 #include <unordered_set>
@@ -14,6 +15,10 @@ namespace chatterino {
 
 /// ChatterSet is a limited container that contains a list of recent chatters
 /// that can be referenced by name.
+///
+/// Names are indexed case-insensitively, so lookups never have to lower case
+/// their argument. A sorted index of the names makes prefix searches only
+/// touch the matching chatters.
 class ChatterSet
 {
 public:
@@ -31,16 +36,74 @@ public:
     void updateOnlineChatters(
         const std::unordered_set<QString> &lowerCaseUsernames);
 
+    /// Starts an update of the online chatters that arrives in several pages.
+    /// Every chatter that isn't passed to addOnlineChatters or chats before
+    /// finishOnlineChattersUpdate is called will be removed.
+    void beginOnlineChattersUpdate();
+
+    /// Marks the chatters as online. Chatters that aren't in the list yet are
+    /// added as long as there's space left.
+    void addOnlineChatters(
+        const std::unordered_set<QString> &lowerCaseUsernames);
+
+    /// Removes chatters that weren't marked as online since
+    /// beginOnlineChattersUpdate.
+    void finishOnlineChattersUpdate();
+
     /// Checks if a username is in the list.
     bool contains(const QString &userName) const;
 
     /// Get filtered usernames by a prefix for autocompletion. Contained items
-    /// are in mixed case if available.
+    /// are in mixed case if available. The most recent chatters come first.
     std::vector<QString> filterByPrefix(const QString &prefix) const;
 
+    size_t size() const;
+
 private:
-    // user name in lower case -> user name in normal case
-    cache::lru_cache<QString, QString> items;
+    struct CaseInsensitiveHash {
+        size_t operator()(const QString &string) const;
+    };
+
+    struct CaseInsensitiveEqual {
+        bool operator()(const QString &a, const QString &b) const
+        {
+            return a.compare(b, Qt::CaseInsensitive) == 0;
+        }
+    };
+
+    struct CaseInsensitiveLess {
+        bool operator()(const QString &a, const QString &b) const
+        {
+            return a.compare(b, Qt::CaseInsensitive) < 0;
+        }
+    };
+
+    struct Chatter {
+        // user name in normal case
+        QString userName;
+        // higher is more recent, 0 if the user hasn't chatted yet
+        uint64_t lastSeen;
+        // onlineGeneration_ at the time the chatter was last seen online
+        uint64_t onlineGeneration;
+        // position in recentChatters_
+        std::list<QString>::iterator recency;
+    };
+
+    /// Removes the chatter pointed to by the given iterator from all indices
+    void remove(
+        std::unordered_map<QString, Chatter, CaseInsensitiveHash,
+                           CaseInsensitiveEqual>::iterator it);
+
+    // user name in lower case -> chatter
+    std::unordered_map<QString, Chatter, CaseInsensitiveHash,
+                       CaseInsensitiveEqual>
+        items_;
+    // user names in lower case, ordered for prefix lookups
+    std::set<QString, CaseInsensitiveLess> sortedNames_;
+    // user names in lower case, most recent chatter at the front
+    std::list<QString> recentChatters_;
+    uint64_t lastSeenCounter_ = 0;
+    uint64_t onlineGeneration_ = 0;
 };
 
 using ChatterSet = ChatterSet;
@@ -0,0 +1,243 @@
+#include "common/EmoteCompletionTable.hpp"
+
+#include <algorithm>
+
+namespace {
+
+using namespace chatterino;
+
+// Base scores of the kinds of matches
+constexpr int EXACT_SCORE = 10000;
+constexpr int PREFIX_SCORE = 8000;
+constexpr int WORD_START_SCORE = 6000;
+constexpr int SUBSTRING_SCORE = 4000;
+constexpr int SUBSEQUENCE_SCORE = 2000;
+
+// Emotes from the last this many completions are ranked higher, the most
+// recent one the most
+constexpr uint64_t USAGE_WINDOW = 100;
+constexpr int USAGE_SCORE = 1500;
+
+uint64_t characterMask(const char16_t *begin, const char16_t *end)
+{
+    uint64_t mask = 0;
+    for (const auto *it = begin; it != end; ++it)
+    {
+        mask |= uint64_t(1) << (*it % 64);
+    }
+    return mask;
+}
+
+// Returns true if the name has a word starting at `pos`, e.g. the "KEKW" in
+// "pepeKEKW" or the "hands" in "raised_hands"
+bool isWordStart(const QString &name, int pos)
+{
+    if (pos == 0)
+    {
+        return true;
+    }
+
+    auto prev = name.at(pos - 1);
+    auto current = name.at(pos);
+    if (!prev.isLetterOrNumber())
+    {
+        return true;
+    }
+
+    return current.isUpper() && prev.isLower();
+}
+
+}  // namespace
+
+namespace chatterino {
+
+void EmoteCompletionTable::clear()
+{
+    this->candidates_.clear();
+    this->names_.clear();
+    this->offsets_.assign(1, 0);
+    this->masks_.clear();
+    this->lastUsed_.clear();
+}
+
+void EmoteCompletionTable::add(EmotePtr emote, const QString &displayName,
+                               const QString &providerName)
+{
+    auto lower = displayName.toLower();
+    const auto *begin = reinterpret_cast<const char16_t *>(lower.utf16());
+    const auto *end = begin + lower.size();
+
+    this->candidates_.push_back({std::move(emote), displayName, providerName});
+    this->names_.insert(this->names_.end(), begin, end);
+    this->offsets_.push_back(uint32_t(this->names_.size()));
+    this->masks_.push_back(characterMask(begin, end));
+
+    auto it = this->usage_.find(lower);
+    this->lastUsed_.push_back(it == this->usage_.end() ? 0 : it->second);
+}
+
+int EmoteCompletionTable::score(size_t index, const QString &query,
+                                uint64_t queryMask) const
+{
+    if ((this->masks_[index] & queryMask) != queryMask)
+    {
+        return -1;
+    }
+
+    const auto *name = this->names_.data() + this->offsets_[index];
+    const auto nameLength =
+        int(this->offsets_[index + 1] - this->offsets_[index]);
+    const auto *q = reinterpret_cast<const char16_t *>(query.utf16());
+    const auto queryLength = int(query.size());
+
+    if (nameLength < queryLength)
+    {
+        return -1;
+    }
+
+    // Shorter names are better matches
+    const auto extra = nameLength - queryLength;
+
+    // Names like ":)" also match without their colon
+    auto skip = (nameLength > queryLength && name[0] == u':') ? 1 : 0;
+    if (extra == skip && std::equal(q, q + queryLength, name + skip))
+    {
+        return EXACT_SCORE;
+    }
+
+    const auto *found =
+        std::search(name, name + nameLength, q, q + queryLength);
+    if (found != name + nameLength)
+    {
+        auto pos = int(found - name);
+        if (pos == 0)
+        {
+            return PREFIX_SCORE - extra;
+        }
+
+        if (isWordStart(this->candidates_[index].displayName, pos))
+        {
+            return WORD_START_SCORE - pos - extra;
+        }
+
+        return SUBSTRING_SCORE - pos - extra;
+    }
+
+    // The characters of the query in order, but not next to each other
+    int gaps = 0;
+    int first = -1;
+    int last = -1;
+    int j = 0;
+    for (int i = 0; i < nameLength && j < queryLength; ++i)
+    {
+        if (name[i] != q[j])
+        {
+            continue;
+        }
+
+        if (first == -1)
+        {
+            first = i;
+        }
+        else if (i != last + 1)
+        {
+            gaps++;
+        }
+        last = i;
+        j++;
+    }
+
+    if (j < queryLength)
+    {
+        return -1;
+    }
+
+    return SUBSEQUENCE_SCORE - 20 * gaps - first - extra;
+}
+
+std::vector<const EmoteCompletionTable::Candidate *>
+    EmoteCompletionTable::query(const QString &query, size_t limit) const
+{
+    auto lower = query.toLower();
+    const auto *begin = reinterpret_cast<const char16_t *>(lower.utf16());
+    auto queryMask = characterMask(begin, begin + lower.size());
+
+    struct Match {
+        int score;
+        size_t index;
+    };
+    std::vector<Match> matches;
+
+    for (size_t i = 0; i < this->candidates_.size(); ++i)
+    {
+        auto score = this->score(i, lower, queryMask);
+        if (score < 0)
+        {
+            continue;
+        }
+
+        auto lastUsed = this->lastUsed_[i];
+        if (lastUsed != 0 && this->usageTick_ - lastUsed < USAGE_WINDOW)
+        {
+            auto age = this->usageTick_ - lastUsed;
+            score += int(USAGE_SCORE * (USAGE_WINDOW - age) / USAGE_WINDOW);
+        }
+
+        matches.push_back({score, i});
+    }
+
+    auto count = std::min(limit, matches.size());
+    std::partial_sort(matches.begin(), matches.begin() + count, matches.end(),
+                      [](const Match &a, const Match &b) {
+                          if (a.score != b.score)
+                          {
+                              return a.score > b.score;
+                          }
+                          return a.index < b.index;
+                      });
+
+    std::vector<const Candidate *> result;
+    result.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        result.push_back(&this->candidates_[matches[i].index]);
+    }
+    return result;
+}
+
+void EmoteCompletionTable::recordUsage(const QString &name)
+{
+    this->usage_[name.toLower()] = ++this->usageTick_;
+
+    for (size_t i = 0; i < this->candidates_.size(); ++i)
+    {
+        if (this->candidates_[i].displayName.compare(
+                name, Qt::CaseInsensitive) == 0)
+        {
+            this->lastUsed_[i] = this->usageTick_;
+        }
+    }
+
+    // Forget emotes that aren't ranked higher anymore
+    if (this->usage_.size() > 2 * USAGE_WINDOW)
+    {
+        for (auto it = this->usage_.begin(); it != this->usage_.end();)
+        {
+            if (this->usageTick_ - it->second >= USAGE_WINDOW)
+            {
+                it = this->usage_.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+}
+
+size_t EmoteCompletionTable::size() const
+{
+    return this->candidates_.size();
+}
+
+}  // namespace chatterino
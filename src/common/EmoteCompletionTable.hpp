@@ -0,0 +1,73 @@
+#pragma once
+
+#include "util/QStringHash.hpp"
+
+#include <QString>
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace chatterino {
+
+struct Emote;
+using EmotePtr = std::shared_ptr<const Emote>;
+
+/// EmoteCompletionTable holds the emotes that can be completed in a channel
+/// and ranks them for a query.
+///
+/// The lower case names of all candidates are stored back to back, so a
+/// query only scans one contiguous buffer. Candidates that don't contain
+/// every character of the query are skipped through a bit mask of their
+/// characters before their name is looked at.
+///
+/// Matches are ranked by how well the name matches (exact, prefix, start of
+/// a word, substring, subsequence), then by how recently the emote was
+/// used, then by the order candidates were added in.
+class EmoteCompletionTable
+{
+public:
+    struct Candidate {
+        EmotePtr emote;
+        QString displayName;
+        QString providerName;
+    };
+
+    /// Removes all candidates. The recent usage is kept.
+    void clear();
+
+    void add(EmotePtr emote, const QString &displayName,
+             const QString &providerName);
+
+    /// Returns up to `limit` candidates matching `query`, best match first.
+    /// The pointers stay valid until the table is changed.
+    std::vector<const Candidate *> query(const QString &query,
+                                         size_t limit) const;
+
+    /// Ranks the emote with the name `name` higher in future queries
+    void recordUsage(const QString &name);
+
+    size_t size() const;
+
+private:
+    int score(size_t index, const QString &query, uint64_t queryMask) const;
+
+    std::vector<Candidate> candidates_;
+    // Lower case names of all candidates, back to back. The name of the
+    // candidate i is in [offsets_[i], offsets_[i + 1]).
+    std::vector<char16_t> names_;
+    std::vector<uint32_t> offsets_{0};
+    // Bit (c % 64) is set for every character c of the candidate's name
+    std::vector<uint64_t> masks_;
+
+    // usageTick_ at the last time the candidate was used, 0 if never
+    std::vector<uint64_t> lastUsed_;
+
+    // Recent usage by lower case name, the value is usageTick_ at the time.
+    // Survives clear() so rebuilding the table keeps the ranking.
+    std::unordered_map<QString, uint64_t> usage_;
+    uint64_t usageTick_ = 0;
+};
+
+}  // namespace chatterino
@@ -16,6 +16,11 @@ using NetworkSuccessCallback = std::function<Outcome(NetworkResult)>;
 using NetworkErrorCallback = std::function<void(NetworkResult)>;
 using NetworkReplyCreatedCallback = std::function<void(QNetworkReply *)>;
 using NetworkFinallyCallback = std::function<void()>;
+/// Second stage of a two-stage success callback, run on the GUI thread
+using NetworkApplyCallback = std::function<void()>;
+/// First stage of a two-stage success callback, run on a worker thread
+using NetworkDecodeCallback =
+    std::function<NetworkApplyCallback(const NetworkResult &)>;
 
 enum class NetworkRequestType {
     Get,
@@ -32,6 +37,19 @@ const static std::vector<QString> networkRequestTypes{
     "PATCH",   //
 };
 
+/// Determines the order in which queued requests to the same host are sent.
+/// Requests of a higher priority are always sent before requests of a lower
+/// priority, regardless of the order they were executed in.
+enum class NetworkRequestPriority {
+    /// The user is actively waiting on the result (e.g. a tooltip or user card)
+    Interactive,
+    /// Required to display chat correctly (e.g. emotes, badges, user lookups)
+    ChatCritical,
+    /// Speculative loads (e.g. prefetching link info or thumbnails).
+    /// Only a small number of these are allowed to run per host at once.
+    Background,
+};
+
 // parseHeaderList takes a list of headers in string form,
 // where each header pair is separated by semicolons (;) and the header name and value is divided by a colon (:)
 //
@@ -8,12 +8,20 @@
 #include "singletons/Paths.hpp"
 #include "util/DebugCount.hpp"
 #include "util/PostToThread.hpp"
+#include "util/QStringHash.hpp"
 
 #include <QCryptographicHash>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QNetworkReply>
 #include <QtConcurrent>
 
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
 namespace chatterino {
 
 NetworkData::NetworkData()
@@ -72,22 +80,353 @@ void writeToCache(const std::shared_ptr<NetworkData> &data,
     }
 }
 
-void loadUncached(const std::shared_ptr<NetworkData> &data)
-{
-    DebugCount::increase("http request started");
+namespace {
+
+    // Matches the number of connections QNetworkAccessManager opens per host.
+    // Anything above this would just sit in Qt's own queue in submission
+    // order, so we keep it in ours where it can be ordered by priority.
+    constexpr int MAX_REQUESTS_PER_HOST = 6;
+    // Background requests can never occupy all slots of a host
+    constexpr int MAX_BACKGROUND_REQUESTS_PER_HOST = 2;
 
-    NetworkRequester requester;
-    NetworkWorker *worker = new NetworkWorker;
+    struct HostQueue {
+        int running = 0;
+        int runningBackground = 0;
+        // One queue per NetworkRequestPriority
+        std::array<std::deque<std::shared_ptr<NetworkData>>, 3> pending;
+    };
 
-    worker->moveToThread(&NetworkManager::workerThread);
+    struct InFlightRequest {
+        std::shared_ptr<NetworkData> leader;
+        // Requests that were merged into the leader's transfer
+        std::vector<std::shared_ptr<NetworkData>> followers;
+    };
 
-    auto onUrlRequested = [data, worker]() mutable {
-        if (data->hasTimeout_)
+    // Only accessed from NetworkManager::workerThread
+    std::unordered_map<QString, HostQueue> hostQueues;
+    std::unordered_map<QString, InFlightRequest> inFlightRequests;
+
+    void startRequest(const std::shared_ptr<NetworkData> &data);
+
+    bool canStart(const HostQueue &host, NetworkRequestPriority priority)
+    {
+        if (host.running >= MAX_REQUESTS_PER_HOST)
         {
-            data->timer_ = new QTimer();
-            data->timer_->setSingleShot(true);
-            data->timer_->start(data->timeoutMS_);
+            return false;
+        }
+
+        return priority != NetworkRequestPriority::Background ||
+               host.runningBackground < MAX_BACKGROUND_REQUESTS_PER_HOST;
+    }
+
+    void startNextRequests(const QString &hostName)
+    {
+        auto it = hostQueues.find(hostName);
+        if (it == hostQueues.end())
+        {
+            return;
+        }
+        auto &host = it->second;
+
+        for (size_t i = 0; i < host.pending.size(); i++)
+        {
+            auto &queue = host.pending[i];
+            while (!queue.empty() &&
+                   canStart(host, NetworkRequestPriority(i)))
+            {
+                auto data = std::move(queue.front());
+                queue.pop_front();
+                startRequest(data);
+            }
+        }
+
+        if (host.running == 0)
+        {
+            // all queues are drained at this point
+            hostQueues.erase(it);
+        }
+    }
+
+    void scheduleRequest(const std::shared_ptr<NetworkData> &data)
+    {
+        auto &host = hostQueues[data->request_.url().host()];
+
+        if (canStart(host, data->priority_))
+        {
+            startRequest(data);
+        }
+        else
+        {
+            DebugCount::increase("http request queued");
+            host.pending[size_t(data->priority_)].push_back(data);
+        }
+    }
+
+    /// Moves a queued leader to a higher priority class if a more urgent
+    /// request was merged into it
+    void promoteRequest(const std::shared_ptr<NetworkData> &data,
+                        NetworkRequestPriority priority)
+    {
+        if (data->started_ || priority >= data->priority_)
+        {
+            return;
+        }
+
+        auto it = hostQueues.find(data->request_.url().host());
+        if (it == hostQueues.end())
+        {
+            return;
+        }
+
+        auto &oldQueue = it->second.pending[size_t(data->priority_)];
+        auto queued = std::find(oldQueue.begin(), oldQueue.end(), data);
+        if (queued == oldQueue.end())
+        {
+            return;
+        }
+        oldQueue.erase(queued);
+
+        data->priority_ = priority;
+        it->second.pending[size_t(priority)].push_back(data);
+        startNextRequests(it->first);
+    }
+
+    void submitRequest(const std::shared_ptr<NetworkData> &data)
+    {
+        auto key = data->getCoalesceKey();
+        if (!key.isEmpty())
+        {
+            auto it = inFlightRequests.find(key);
+            if (it != inFlightRequests.end())
+            {
+                DebugCount::increase("http request coalesced");
+                it->second.followers.push_back(data);
+                promoteRequest(it->second.leader, data->priority_);
+                return;
+            }
+
+            data->coalesceKey_ = key;
+            inFlightRequests.emplace(key, InFlightRequest{data, {}});
+        }
+
+        scheduleRequest(data);
+    }
+
+    /// Frees the host slot of the given request and returns all requests that
+    /// were waiting on its transfer, including the request itself
+    std::vector<std::shared_ptr<NetworkData>> finishRequest(
+        const std::shared_ptr<NetworkData> &data)
+    {
+        std::vector<std::shared_ptr<NetworkData>> targets{data};
+
+        if (!data->coalesceKey_.isEmpty())
+        {
+            auto it = inFlightRequests.find(data->coalesceKey_);
+            if (it != inFlightRequests.end())
+            {
+                for (auto &follower : it->second.followers)
+                {
+                    targets.push_back(std::move(follower));
+                }
+                inFlightRequests.erase(it);
+            }
+        }
+
+        auto hostName = data->request_.url().host();
+        auto it = hostQueues.find(hostName);
+        if (it != hostQueues.end())
+        {
+            it->second.running--;
+            if (data->priority_ == NetworkRequestPriority::Background)
+            {
+                it->second.runningBackground--;
+            }
+        }
+        startNextRequests(hostName);
+
+        return targets;
+    }
+
+    void logReply(const std::shared_ptr<NetworkData> &data, int status)
+    {
+        if (data->requestType_ == NetworkRequestType::Get)
+        {
+            qCDebug(chatterinoHTTP)
+                << QString("%1 %2 %3")
+                       .arg(networkRequestTypes.at(int(data->requestType_)),
+                            QString::number(status),
+                            data->request_.url().toString());
+        }
+        else
+        {
+            qCDebug(chatterinoHTTP)
+                << QString("%1 %2 %3 %4")
+                       .arg(networkRequestTypes.at(int(data->requestType_)),
+                            QString::number(status),
+                            data->request_.url().toString(),
+                            QString(data->payload_));
+        }
+    }
+
+    /// Calls onError and finally of every request that was waiting on a
+    /// transfer that ended without a usable reply
+    void failRequests(const std::vector<std::shared_ptr<NetworkData>> &targets,
+                      const NetworkResult &result)
+    {
+        for (const auto &target : targets)
+        {
+            postToThread([target, result] {
+                if (target->hasCaller_ && !target->caller_.get())
+                {
+                    return;
+                }
+
+                if (target->onError_)
+                {
+                    target->onError_(result);
+                }
+
+                if (target->finally_)
+                {
+                    target->finally_();
+                }
+            });
+        }
+    }
+
+    void runFinally(const std::shared_ptr<NetworkData> &data)
+    {
+        if (!data->finally_)
+        {
+            return;
+        }
+
+        if (data->executeConcurrently_)
+        {
+            QtConcurrent::run([finally = std::move(data->finally_)] {
+                finally();
+            });
+        }
+        else
+        {
+            data->finally_();
         }
+    }
+
+    /// Runs the decode stage of a two-stage callback on the calling thread
+    /// and posts its apply stage to the GUI thread
+    void decodeReply(const std::shared_ptr<NetworkData> &data,
+                     const NetworkResult &result)
+    {
+        auto apply = data->onDecode_(result);
+
+        postToThread([data, apply = std::move(apply)] {
+            if (data->hasCaller_ && !data->caller_.get())
+            {
+                return;
+            }
+
+            if (apply)
+            {
+                QElapsedTimer timer;
+                timer.start();
+
+                apply();
+
+                auto elapsedUs = timer.nsecsElapsed() / 1000;
+                DebugCount::increase("http gui thread apply");
+                DebugCount::increase("http gui thread apply (us)", elapsedUs);
+                qCDebug(chatterinoHTTP)
+                    << QString("applied %1 in %2ms")
+                           .arg(data->request_.url().toString())
+                           .arg(double(elapsedUs) / 1000.0);
+            }
+
+            if (data->finally_)
+            {
+                data->finally_();
+            }
+        });
+    }
+
+    /// Invokes the callbacks of a single request with the outcome of the
+    /// transfer it was part of
+    void deliverReply(const std::shared_ptr<NetworkData> &data, bool isError,
+                      const NetworkResult &result)
+    {
+        if (!isError && data->onDecode_)
+        {
+            // Keep the decoding off both the network and the GUI thread
+            QtConcurrent::run([data, result] {
+                decodeReply(data, result);
+            });
+            return;
+        }
+
+        auto handleReply = [data, isError, result]() mutable {
+            if (data->hasCaller_ && !data->caller_.get())
+            {
+                return;
+            }
+
+            if (isError)
+            {
+                if (data->onError_)
+                {
+                    // TODO: Should this always be run on the GUI thread?
+                    runInGuiThread([data, result] {
+                        data->onError_(result);
+                    });
+                }
+
+                if (data->finally_)
+                {
+                    runInGuiThread([data] {
+                        data->finally_();
+                    });
+                }
+                return;
+            }
+
+            if (data->onSuccess_)
+            {
+                if (data->executeConcurrently_)
+                {
+                    QtConcurrent::run([onSuccess = std::move(data->onSuccess_),
+                                       result = std::move(result)] {
+                        onSuccess(result);
+                    });
+                }
+                else
+                {
+                    // Measured so it can be compared with onSuccessDecoded
+                    QElapsedTimer timer;
+                    timer.start();
+
+                    data->onSuccess_(result);
+
+                    DebugCount::increase("http gui thread callback");
+                    DebugCount::increase("http gui thread callback (us)",
+                                         timer.nsecsElapsed() / 1000);
+                }
+            }
+
+            runFinally(data);
+        };
+
+        if (data->executeConcurrently_)
+        {
+            handleReply();
+        }
+        else
+        {
+            postToThread(std::move(handleReply));
+        }
+    }
+
+    void startRequest(const std::shared_ptr<NetworkData> &data)
+    {
+        data->started_ = true;
 
         auto reply = [&]() -> QNetworkReply * {
             switch (data->requestType_)
@@ -136,36 +475,49 @@ void loadUncached(const std::shared_ptr<NetworkData> &data)
         if (reply == nullptr)
         {
             qCDebug(chatterinoCommon) << "Unhandled request type";
+
+            std::vector<std::shared_ptr<NetworkData>> targets{data};
+            if (!data->coalesceKey_.isEmpty())
+            {
+                auto it = inFlightRequests.find(data->coalesceKey_);
+                if (it != inFlightRequests.end())
+                {
+                    for (auto &follower : it->second.followers)
+                    {
+                        targets.push_back(std::move(follower));
+                    }
+                    inFlightRequests.erase(it);
+                }
+            }
+
+            failRequests(targets, NetworkResult({}, 0));
             return;
         }
 
-        if (data->timer_ != nullptr && data->timer_->isActive())
+        auto &host = hostQueues[data->request_.url().host()];
+        host.running++;
+        if (data->priority_ == NetworkRequestPriority::Background)
         {
+            host.runningBackground++;
+        }
+
+        auto timedOut = std::make_shared<bool>(false);
+
+        if (data->hasTimeout_)
+        {
+            data->timer_ = new QTimer();
+            data->timer_->setSingleShot(true);
+            data->timer_->start(data->timeoutMS_);
+
             QObject::connect(
-                data->timer_, &QTimer::timeout, worker, [reply, data]() {
+                data->timer_, &QTimer::timeout, &NetworkManager::accessManager,
+                [reply, data, timedOut]() {
                     qCDebug(chatterinoCommon) << "Aborted!";
+                    *timedOut = true;
                     reply->abort();
-                    qCDebug(chatterinoHTTP)
-                        << QString("%1 [timed out] %2")
-                               .arg(networkRequestTypes.at(
-                                        int(data->requestType_)),
-                                    data->request_.url().toString());
-
-                    if (data->onError_)
-                    {
-                        postToThread([data] {
-                            data->onError_(NetworkResult(
-                                {}, NetworkResult::timedoutStatus));
-                        });
-                    }
-
-                    if (data->finally_)
-                    {
-                        postToThread([data] {
-                            data->finally_();
-                        });
-                    }
                 });
+            QObject::connect(reply, &QNetworkReply::finished, data->timer_,
+                             &QObject::deleteLater);
         }
 
         if (data->onReplyCreated_)
@@ -173,146 +525,112 @@ void loadUncached(const std::shared_ptr<NetworkData> &data)
             data->onReplyCreated_(reply);
         }
 
-        auto handleReply = [data, reply]() mutable {
-            if (data->hasCaller_ && !data->caller_.get())
-            {
-                return;
-            }
+        QObject::connect(
+            reply, &QNetworkReply::finished, &NetworkManager::accessManager,
+            [data, reply, timedOut]() {
+                reply->deleteLater();
+
+                // TODO(pajlada): A reply was received, kill the timeout timer
+                auto targets = finishRequest(data);
 
-            // TODO(pajlada): A reply was received, kill the timeout timer
-            if (reply->error() != QNetworkReply::NetworkError::NoError)
-            {
                 if (reply->error() ==
                     QNetworkReply::NetworkError::OperationCanceledError)
                 {
-                    // Operation cancelled, most likely timed out
+                    if (!*timedOut)
+                    {
+                        // Operation cancelled by someone else
+                        qCDebug(chatterinoHTTP)
+                            << QString("%1 [cancelled] %2")
+                                   .arg(networkRequestTypes.at(
+                                            int(data->requestType_)),
+                                        data->request_.url().toString());
+
+                        // Only the request itself was cancelled, the ones
+                        // merged into it still expect an answer
+                        targets.erase(targets.begin());
+                        failRequests(targets, NetworkResult({}, 0));
+                        return;
+                    }
+
                     qCDebug(chatterinoHTTP)
-                        << QString("%1 [cancelled] %2")
+                        << QString("%1 [timed out] %2")
                                .arg(networkRequestTypes.at(
                                         int(data->requestType_)),
                                     data->request_.url().toString());
+
+                    NetworkResult result({}, NetworkResult::timedoutStatus);
+                    failRequests(targets, result);
                     return;
                 }
 
-                if (data->onError_)
+                auto status =
+                    reply->attribute(QNetworkRequest::HttpStatusCodeAttribute)
+                        .toInt();
+                bool isError =
+                    reply->error() != QNetworkReply::NetworkError::NoError;
+                NetworkResult result(reply->readAll(), status);
+
+                logReply(data, status);
+
+                if (!isError)
                 {
-                    auto status = reply->attribute(
-                        QNetworkRequest::HttpStatusCodeAttribute);
-                    if (data->requestType_ == NetworkRequestType::Get)
-                    {
-                        qCDebug(chatterinoHTTP)
-                            << QString("%1 %2 %3")
-                                   .arg(networkRequestTypes.at(
-                                            int(data->requestType_)),
-                                        QString::number(status.toInt()),
-                                        data->request_.url().toString());
-                    }
-                    else
+                    DebugCount::increase("http request success");
+
+                    auto cached = std::find_if(
+                        targets.begin(), targets.end(), [](const auto &target) {
+                            return target->cache_;
+                        });
+                    if (cached != targets.end())
                     {
-                        qCDebug(chatterinoHTTP)
-                            << QString("%1 %2 %3 %4")
-                                   .arg(networkRequestTypes.at(
-                                            int(data->requestType_)),
-                                        QString::number(status.toInt()),
-                                        data->request_.url().toString(),
-                                        QString(data->payload_));
+                        writeToCache(*cached, result.getData());
                     }
-                    // TODO: Should this always be run on the GUI thread?
-                    postToThread([data, code = status.toInt(), reply] {
-                        data->onError_(NetworkResult(reply->readAll(), code));
-                    });
                 }
 
-                if (data->finally_)
+                for (const auto &target : targets)
                 {
-                    postToThread([data] {
-                        data->finally_();
-                    });
+                    deliverReply(target, isError, result);
                 }
-                return;
-            }
-
-            QByteArray bytes = reply->readAll();
-            writeToCache(data, bytes);
-
-            auto status =
-                reply->attribute(QNetworkRequest::HttpStatusCodeAttribute);
+            });
+    }
 
-            NetworkResult result(bytes, status.toInt());
+}  // namespace
 
-            DebugCount::increase("http request success");
-            // log("starting {}", data->request_.url().toString());
-            if (data->onSuccess_)
-            {
-                if (data->executeConcurrently_)
-                    QtConcurrent::run([onSuccess = std::move(data->onSuccess_),
-                                       result = std::move(result)] {
-                        onSuccess(result);
-                    });
-                else
-                    data->onSuccess_(result);
-            }
-            // log("finished {}", data->request_.url().toString());
+QString NetworkData::getCoalesceKey() const
+{
+    // Only idempotent requests without access to their reply can share it
+    if (this->requestType_ != NetworkRequestType::Get ||
+        this->onReplyCreated_)
+    {
+        return {};
+    }
 
-            reply->deleteLater();
+    QString key = this->request_.url().toString();
 
-            if (data->requestType_ == NetworkRequestType::Get)
-            {
-                qCDebug(chatterinoHTTP)
-                    << QString("%1 %2 %3")
-                           .arg(networkRequestTypes.at(int(data->requestType_)),
-                                QString::number(status.toInt()),
-                                data->request_.url().toString());
-            }
-            else
-            {
-                qCDebug(chatterinoHTTP)
-                    << QString("%1 %3 %2 %4")
-                           .arg(networkRequestTypes.at(int(data->requestType_)),
-                                data->request_.url().toString(),
-                                QString::number(status.toInt()),
-                                QString(data->payload_));
-            }
-            if (data->finally_)
-            {
-                if (data->executeConcurrently_)
-                    QtConcurrent::run([finally = std::move(data->finally_)] {
-                        finally();
-                    });
-                else
-                    data->finally_();
-            }
-        };
+    for (const auto &header : this->request_.rawHeaderList())
+    {
+        key += '\n' + QString::fromUtf8(header) + ':' +
+               QString::fromUtf8(this->request_.rawHeader(header));
+    }
 
-        if (data->timer_ != nullptr)
-        {
-            QObject::connect(reply, &QNetworkReply::finished, data->timer_,
-                             &QObject::deleteLater);
-        }
+    // Requests with different timeouts must not time out together
+    if (this->hasTimeout_)
+    {
+        key += "\ntimeout:" + QString::number(this->timeoutMS_);
+    }
 
-        QObject::connect(
-            reply, &QNetworkReply::finished, worker,
-            [data, handleReply, worker]() mutable {
-                if (data->executeConcurrently_ || isGuiThread())
-                {
-                    handleReply();
-                    delete worker;
-                }
-                else
-                {
-                    postToThread(
-                        [worker, cb = std::move(handleReply)]() mutable {
-                            cb();
-                            delete worker;
-                        });
-                }
-            });
-    };
+    return key;
+}
 
-    QObject::connect(&requester, &NetworkRequester::requestUrl, worker,
-                     onUrlRequested);
+void loadUncached(const std::shared_ptr<NetworkData> &data)
+{
+    DebugCount::increase("http request started");
 
-    emit requester.requestUrl();
+    // The scheduler state is owned by the network worker thread
+    postToThread(
+        [data] {
+            submitRequest(data);
+        },
+        &NetworkManager::accessManager);
 }
 
 // First tried to load cached, then uncached.
@@ -336,6 +654,13 @@ void loadCached(const std::shared_ptr<NetworkData> &data)
             << QString("%1 [CACHED] 200 %2")
                    .arg(networkRequestTypes.at(int(data->requestType_)),
                         data->request_.url().toString());
+        if (data->onDecode_)
+        {
+            // We're already on a worker thread here
+            decodeReply(data, result);
+            return;
+        }
+
         if (data->onSuccess_)
         {
             if (data->executeConcurrently_ || isGuiThread())
@@ -16,22 +16,6 @@ namespace chatterino {
 
 class NetworkResult;
 
-class NetworkRequester : public QObject
-{
-    Q_OBJECT
-
-signals:
-    void requestUrl();
-};
-
-class NetworkWorker : public QObject
-{
-    Q_OBJECT
-
-signals:
-    void doneUrl();
-};
-
 struct NetworkData {
     NetworkData();
     ~NetworkData();
@@ -45,9 +29,11 @@ struct NetworkData {
     NetworkReplyCreatedCallback onReplyCreated_;
     NetworkErrorCallback onError_;
     NetworkSuccessCallback onSuccess_;
+    NetworkDecodeCallback onDecode_;
     NetworkFinallyCallback finally_;
 
     NetworkRequestType requestType_ = NetworkRequestType::Get;
+    NetworkRequestPriority priority_ = NetworkRequestPriority::ChatCritical;
 
     QByteArray payload_;
     // lifetime secured by lifetimeManager_
@@ -64,6 +50,16 @@ struct NetworkData {
 
     QString getHash();
 
+    /// Returns the key under which identical in-flight requests are merged,
+    /// or an empty string if this request must get its own transfer
+    QString getCoalesceKey() const;
+
+    // The following are only accessed from NetworkManager::workerThread
+    // Set once the request has left the per-host queue
+    bool started_{};
+    // Key this request was registered under as the leader of a transfer
+    QString coalesceKey_;
+
 private:
     QString hash_;
 };
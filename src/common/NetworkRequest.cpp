@@ -79,6 +79,12 @@ NetworkRequest NetworkRequest::onSuccess(NetworkSuccessCallback cb) &&
     return std::move(*this);
 }
 
+NetworkRequest NetworkRequest::onDecode(NetworkDecodeCallback cb) &&
+{
+    this->data->onDecode_ = cb;
+    return std::move(*this);
+}
+
 NetworkRequest NetworkRequest::finally(NetworkFinallyCallback cb) &&
 {
     this->data->finally_ = cb;
@@ -129,6 +135,12 @@ NetworkRequest NetworkRequest::concurrent() &&
     return std::move(*this);
 }
 
+NetworkRequest NetworkRequest::priority(NetworkRequestPriority priority) &&
+{
+    this->data->priority_ = priority;
+    return std::move(*this);
+}
+
 NetworkRequest NetworkRequest::authorizeTwitchV5(const QString &clientID,
                                                  const QString &oauthToken) &&
 {
@@ -177,6 +189,11 @@ void NetworkRequest::execute()
     // Can not have a caller and be concurrent at the same time.
     assert(!(this->data->caller_ && this->data->executeConcurrently_));
 
+    // The apply stage of a two-stage callback always runs on the GUI thread,
+    // and only one kind of success callback can be used at a time.
+    assert(!(this->data->onDecode_ && this->data->executeConcurrently_));
+    assert(!(this->data->onDecode_ && this->data->onSuccess_));
+
     load(std::move(this->data));
 }
 
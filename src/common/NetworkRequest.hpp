@@ -6,6 +6,7 @@
 #include <QHttpMultiPart>
 
 #include <memory>
+#include <type_traits>
 
 namespace chatterino {
 
@@ -43,6 +44,26 @@ public:
     NetworkRequest onReplyCreated(NetworkReplyCreatedCallback cb) &&;
     NetworkRequest onError(NetworkErrorCallback cb) &&;
     NetworkRequest onSuccess(NetworkSuccessCallback cb) &&;
+    /// Two-stage alternative to onSuccess for responses that are expensive to
+    /// parse. `decode` runs on a worker thread and turns the result into an
+    /// immutable value. `apply` then receives that value on the GUI thread and
+    /// should do nothing but publish it (e.g. swap a pointer).
+    /// `decode` must not touch any GUI state.
+    template <typename Decode, typename Apply>
+    NetworkRequest onSuccessDecoded(Decode decode, Apply apply) &&
+    {
+        using Decoded = std::decay_t<
+            std::invoke_result_t<const Decode &, const NetworkResult &>>;
+
+        return std::move(*this).onDecode(
+            [decode = std::move(decode), apply = std::move(apply)](
+                const NetworkResult &result) -> NetworkApplyCallback {
+                auto decoded = std::make_shared<Decoded>(decode(result));
+                return [apply, decoded] {
+                    apply(std::move(*decoded));
+                };
+            });
+    }
     NetworkRequest finally(NetworkFinallyCallback cb) &&;
 
     NetworkRequest payload(const QByteArray &payload) &&;
@@ -59,16 +80,23 @@ public:
         const std::vector<std::pair<QByteArray, QByteArray>> &headers) &&;
     NetworkRequest timeout(int ms) &&;
     NetworkRequest concurrent() &&;
+    /// Requests are sent in order of their priority when too many requests to
+    /// the same host are running. Defaults to ChatCritical.
+    NetworkRequest priority(NetworkRequestPriority priority) &&;
     NetworkRequest authorizeTwitchV5(const QString &clientID,
                                      const QString &oauthToken = QString()) &&;
     NetworkRequest multiPart(QHttpMultiPart *payload) &&;
 
+    /// Identical GET requests that are in flight at the same time share one
+    /// transfer, each of them receiving the callbacks it registered.
     void execute();
 
     static NetworkRequest twitchRequest(QUrl url);
 
 private:
     void initializeDefaultValues();
+
+    NetworkRequest onDecode(NetworkDecodeCallback cb) &&;
 };
 
 }  // namespace chatterino
@@ -90,6 +90,41 @@ namespace {
         return filterIds;
     }
 
+    QJsonObject saveNode(const NodeDescriptor &node)
+    {
+        QJsonObject obj;
+
+        if (const auto *split = std::get_if<SplitNodeDescriptor>(&node))
+        {
+            obj.insert("type", "split");
+
+            QJsonObject data;
+            split->saveToJSON(obj, data);
+            obj.insert("data", data);
+
+            obj.insert("flexh", split->flexH_);
+            obj.insert("flexv", split->flexV_);
+        }
+        else if (const auto *container =
+                     std::get_if<ContainerNodeDescriptor>(&node))
+        {
+            obj.insert("type",
+                       container->vertical_ ? "vertical" : "horizontal");
+
+            QJsonArray items;
+            for (const auto &item : container->items_)
+            {
+                items.append(saveNode(item));
+            }
+            obj.insert("items", items);
+
+            obj.insert("flexh", container->flexH_);
+            obj.insert("flexv", container->flexV_);
+        }
+
+        return obj;
+    }
+
 }  // namespace
 
 void SplitDescriptor::loadFromJSON(SplitDescriptor &descriptor,
@@ -110,6 +145,37 @@ void SplitDescriptor::loadFromJSON(SplitDescriptor &descriptor,
     descriptor.filters_ = loadFilters(root.value("filters"));
 }
 
+void SplitDescriptor::saveToJSON(QJsonObject &root, QJsonObject &data) const
+{
+    root.insert("moderationMode", this->moderationMode_);
+
+    QJsonArray filters;
+    for (const auto &filter : this->filters_)
+    {
+        filters.append(filter.toString(QUuid::WithoutBraces));
+    }
+    root.insert("filters", filters);
+
+    if (this->type_.isEmpty())
+    {
+        return;
+    }
+
+    data.insert("type", this->type_);
+    if (this->type_ == "irc")
+    {
+        if (this->server_ != -1)
+        {
+            data.insert("server", this->server_);
+        }
+        data.insert("channel", this->channelName_);
+    }
+    else if (!this->channelName_.isEmpty())
+    {
+        data.insert("name", this->channelName_);
+    }
+}
+
 TabDescriptor TabDescriptor::loadFromJSON(const QJsonObject &tabObj)
 {
     TabDescriptor tab;
@@ -146,6 +212,32 @@ TabDescriptor TabDescriptor::loadFromJSON(const QJsonObject &tabObj)
     return tab;
 }
 
+QJsonObject TabDescriptor::toJSON() const
+{
+    QJsonObject obj;
+
+    // custom tab title
+    if (!this->customTitle_.isEmpty())
+    {
+        obj.insert("title", this->customTitle_);
+    }
+
+    // selected
+    if (this->selected_)
+    {
+        obj.insert("selected", true);
+    }
+
+    // highlighting on new messages
+    obj.insert("highlightsEnabled", this->highlightsEnabled_);
+
+    // splits
+    obj.insert("splits2",
+               this->rootNode_ ? saveNode(*this->rootNode_) : QJsonObject());
+
+    return obj;
+}
+
 WindowLayout WindowLayout::loadFromFile(const QString &path)
 {
     WindowLayout layout;
@@ -229,4 +321,61 @@ WindowLayout WindowLayout::loadFromFile(const QString &path)
     return layout;
 }
 
+QJsonDocument WindowLayout::toJSON() const
+{
+    QJsonArray windowArr;
+    for (const auto &window : this->windows_)
+    {
+        QJsonObject windowObj;
+
+        // window type
+        switch (window.type_)
+        {
+            case WindowType::Main:
+                windowObj.insert("type", "main");
+                break;
+
+            case WindowType::Popup:
+                windowObj.insert("type", "popup");
+                break;
+
+            case WindowType::Attached:;
+        }
+
+        if (window.state_ == WindowDescriptor::State::Maximized)
+        {
+            windowObj.insert("state", "maximized");
+        }
+        else if (window.state_ == WindowDescriptor::State::Minimized)
+        {
+            windowObj.insert("state", "minimized");
+        }
+
+        // window geometry
+        windowObj.insert("x", window.geometry_.x());
+        windowObj.insert("y", window.geometry_.y());
+        windowObj.insert("width", window.geometry_.width());
+        windowObj.insert("height", window.geometry_.height());
+
+        QJsonObject emotePopupObj;
+        emotePopupObj.insert("x", this->emotePopupPos_.x());
+        emotePopupObj.insert("y", this->emotePopupPos_.y());
+        windowObj.insert("emotePopup", emotePopupObj);
+
+        // window tabs
+        QJsonArray tabsArr;
+        for (const auto &tab : window.tabs_)
+        {
+            tabsArr.append(tab.toJSON());
+        }
+
+        windowObj.insert("tabs", tabsArr);
+        windowArr.append(windowObj);
+    }
+
+    QJsonObject obj;
+    obj.insert("windows", windowArr);
+    return QJsonDocument(obj);
+}
+
 }  // namespace chatterino
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QJsonDocument>
 #include <QJsonObject>
 #include <QList>
 #include <QRect>
@@ -46,6 +47,8 @@ struct SplitDescriptor {
 
     static void loadFromJSON(SplitDescriptor &descriptor,
                              const QJsonObject &root, const QJsonObject &data);
+    // Writes the split's fields into `root` and its channel into `data`
+    void saveToJSON(QJsonObject &root, QJsonObject &data) const;
 };
 
 struct SplitNodeDescriptor : SplitDescriptor {
@@ -69,6 +72,7 @@ struct ContainerNodeDescriptor {
 
 struct TabDescriptor {
     static TabDescriptor loadFromJSON(const QJsonObject &root);
+    QJsonObject toJSON() const;
 
     QString customTitle_;
     bool selected_{false};
@@ -97,6 +101,9 @@ class WindowLayout
 public:
     static WindowLayout loadFromFile(const QString &path);
 
+    // Serializes the layout in the format read by loadFromFile
+    QJsonDocument toJSON() const;
+
     // A complete window layout has a single emote popup position that is shared among all windows
     QPoint emotePopupPos_;
 
@@ -45,6 +45,8 @@
 #include <QRegularExpression>
 #include <QUrl>
 
+#include <algorithm>
+
 namespace {
 
 using namespace chatterino;
@@ -94,7 +96,7 @@ bool appendWhisperMessageWordsLocally(const QStringList &words)
 
     MessageBuilder b;
 
-    b.emplace<TimestampElement>();
+    b.appendTimestamp();
     b.emplace<TextElement>(app->accounts->twitch.getCurrent()->getUserName(),
                            MessageElementFlag::Text, MessageColor::Text,
                            FontStyle::ChatMediumBold);
@@ -790,7 +792,7 @@ void CommandController::initialize(Settings &, Paths &paths)
         for (QString &str : debugMessages)
         {
             MessageBuilder builder;
-            builder.emplace<TimestampElement>(QTime::currentTime());
+            builder.appendTimestamp(QTime::currentTime());
             builder.emplace<TextElement>(str, MessageElementFlag::Text,
                                          MessageColor::System);
             channel->addMessage(builder.release());
@@ -895,6 +897,16 @@ void CommandController::initialize(Settings &, Paths &paths)
                 auto *page = notebook.getPageAt(i);
                 auto *container = dynamic_cast<SplitContainer *>(page);
                 assert(container != nullptr);
+
+                // Tabs that weren't shown yet only hold on to their channels
+                auto channels = container->getChannels();
+                if (std::find(channels.begin(), channels.end(), channel) ==
+                    channels.end())
+                {
+                    continue;
+                }
+                container->createPendingSplits();
+
                 for (auto *split : container->getSplits())
                 {
                     if (split->getChannel() == channel)
@@ -903,6 +915,11 @@ void CommandController::initialize(Settings &, Paths &paths)
                         break;
                     }
                 }
+                if (currentSplit != nullptr &&
+                    currentSplit->getChannel() == channel)
+                {
+                    break;
+                }
             }
 
             // This would have crashed either way.
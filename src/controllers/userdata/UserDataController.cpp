@@ -1,30 +1,80 @@
 #include "controllers/userdata/UserDataController.hpp"
 
+#include "common/QLogging.hpp"
 #include "singletons/Paths.hpp"
 #include "util/CombinePath.hpp"
+#include "util/DebugCount.hpp"
+#include "util/PostToThread.hpp"
+
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+#include <QElapsedTimer>
+#include <QSaveFile>
+#include <QThreadPool>
 
 namespace {
 
 using namespace chatterino;
 
+// Changes are collected for this long before they're written
+constexpr int SAVE_DELAY = 2000;
+
+QString userDataPath()
+{
+    return combinePath(getPaths()->settingsDirectory, "user-data.json");
+}
+
 std::shared_ptr<pajlada::Settings::SettingManager> initSettingsInstance()
 {
     auto sm = std::make_shared<pajlada::Settings::SettingManager>();
 
-    auto *paths = getPaths();
-
-    auto path = combinePath(paths->settingsDirectory, "user-data.json");
-
-    sm->setPath(path.toUtf8().toStdString());
+    sm->setPath(userDataPath().toUtf8().toStdString());
 
     sm->setBackupEnabled(true);
     sm->setBackupSlots(9);
-    sm->saveMethod =
-        pajlada::Settings::SettingManager::SaveMethod::SaveAllTheTime;
+    // Changes are written by UserDataController::queueSave, the setting
+    // manager only writes on exit
+    sm->saveMethod = pajlada::Settings::SettingManager::SaveMethod::SaveOnExit;
 
     return sm;
 }
 
+// Writes the users in the same format as the setting manager
+bool writeUsers(const QString &path,
+                const std::unordered_map<QString, UserData> &users)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    rapidjson::Document doc(rapidjson::kObjectType);
+    auto &a = doc.GetAllocator();
+    doc.AddMember(
+        "users",
+        pajlada::Serialize<std::unordered_map<QString, UserData>>::get(users,
+                                                                       a),
+        a);
+
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    doc.Accept(writer);
+
+    // QSaveFile replaces the old file only once everything was written
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly) ||
+        file.write(buffer.GetString(), qint64(buffer.GetSize())) == -1 ||
+        !file.commit())
+    {
+        qCWarning(chatterinoSettings)
+            << "Failed to write user data to" << path << file.errorString();
+        return false;
+    }
+
+    DebugCount::increase("user data writes");
+    DebugCount::increase("user data write time (us)",
+                         timer.nsecsElapsed() / 1000);
+    return true;
+}
+
 }  // namespace
 
 namespace chatterino {
@@ -32,14 +82,30 @@ namespace chatterino {
 UserDataController::UserDataController()
     : sm(initSettingsInstance())
     , setting("/users", this->sm)
+    , writeState_(std::make_shared<WriteState>())
 {
     this->sm->load();
     this->users = this->setting.getValue();
+
+    this->saveTimer_.setSingleShot(true);
+    this->saveTimer_.setInterval(SAVE_DELAY);
+    QObject::connect(&this->saveTimer_, &QTimer::timeout, [this] {
+        this->saveAsync();
+    });
 }
 
 void UserDataController::save()
 {
+    this->saveTimer_.stop();
+
+    // Waits for a write that's still in progress
+    std::lock_guard writeLock(this->writeState_->mutex);
+    {
+        std::shared_lock lock(this->usersMutex);
+        this->setting.setValue(this->users);
+    }
     this->sm->save();
+    this->writeState_->writtenGeneration = this->generation_;
 }
 
 boost::optional<UserData> UserDataController::getUser(
@@ -56,45 +122,69 @@ boost::optional<UserData> UserDataController::getUser(
     return it->second;
 }
 
-std::unordered_map<QString, UserData> UserDataController::getUsers() const
-{
-    std::shared_lock lock(this->usersMutex);
-    return this->users;
-}
-
 void UserDataController::setUserColor(const QString &userID,
                                       const QString &colorString)
 {
-    auto c = this->getUsers();
-    auto it = c.find(userID);
     boost::optional<QColor> finalColor =
         boost::make_optional(!colorString.isEmpty(), QColor(colorString));
-    if (it == c.end())
+
     {
-        if (!finalColor)
+        std::unique_lock lock(this->usersMutex);
+        auto it = this->users.find(userID);
+        if (it == this->users.end())
         {
-            // Early out - user is not configured and will not get a new color
-            return;
+            if (!finalColor)
+            {
+                // Early out - user is not configured and will not get a new
+                // color
+                return;
+            }
+
+            UserData user;
+            user.color = finalColor;
+            this->users.insert({userID, user});
+        }
+        else
+        {
+            it->second.color = finalColor;
         }
-
-        UserData user;
-        user.color = finalColor;
-        c.insert({userID, user});
     }
-    else
+
+    this->queueSave();
+}
+
+void UserDataController::queueSave()
+{
+    this->generation_++;
+    if (!this->saveTimer_.isActive())
     {
-        it->second.color = finalColor;
+        this->saveTimer_.start();
     }
-
-    this->update(std::move(c));
 }
 
-void UserDataController::update(
-    std::unordered_map<QString, UserData> &&newUsers)
+void UserDataController::saveAsync()
 {
-    std::unique_lock lock(this->usersMutex);
-    this->users = std::move(newUsers);
-    this->setting.setValue(this->users);
+    auto generation = this->generation_;
+    std::unordered_map<QString, UserData> snapshot;
+    {
+        std::shared_lock lock(this->usersMutex);
+        snapshot = this->users;
+    }
+
+    QThreadPool::globalInstance()->start(new LambdaRunnable(
+        [state = this->writeState_, path = userDataPath(), generation,
+         snapshot = std::move(snapshot)] {
+            std::lock_guard lock(state->mutex);
+            if (state->writtenGeneration >= generation)
+            {
+                return;
+            }
+
+            if (writeUsers(path, snapshot))
+            {
+                state->writtenGeneration = generation;
+            }
+        }));
 }
 
 }  // namespace chatterino
@@ -11,7 +11,11 @@
 #include <pajlada/settings.hpp>
 #include <QColor>
 #include <QString>
+#include <QTimer>
 
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <shared_mutex>
 #include <unordered_map>
 
@@ -42,12 +46,14 @@ public:
                       const QString &colorString) override;
 
 protected:
+    // Writes all pending changes synchronously, called on exit
     void save() override;
 
 private:
-    void update(std::unordered_map<QString, UserData> &&newUsers);
-
-    std::unordered_map<QString, UserData> getUsers() const;
+    // Schedules a write of the user data on a worker thread. Changes within
+    // the debounce interval are written together.
+    void queueSave();
+    void saveAsync();
 
     // Stores a real-time list of users & their customizations
     std::unordered_map<QString, UserData> users;
@@ -55,6 +61,20 @@ private:
 
     std::shared_ptr<pajlada::Settings::SettingManager> sm;
     pajlada::Settings::Setting<std::unordered_map<QString, UserData>> setting;
+
+    QTimer saveTimer_;
+    // Incremented for every change
+    uint64_t generation_ = 0;
+
+    // Shared with the worker threads writing the file, so they never refer
+    // to the controller
+    struct WriteState {
+        std::mutex mutex;
+        // The generation of the data on disk. Older snapshots are dropped, so
+        // out of order writes can't undo a change.
+        uint64_t writtenGeneration = 0;
+    };
+    std::shared_ptr<WriteState> writeState_;
 };
 
 }  // namespace chatterino
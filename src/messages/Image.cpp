@@ -166,6 +166,11 @@ namespace detail {
         return this->items_.front().image;
     }
 
+    int Frames::currentIndex() const
+    {
+        return this->index_;
+    }
+
     // functions
     QVector<Frame<QImage>> readFrames(QImageReader &reader, const Url &url)
     {
@@ -439,6 +444,13 @@ bool Image::animated() const
     return this->frames_->animated();
 }
 
+int Image::currentFrameIndex() const
+{
+    assertInGuiThread();
+
+    return this->frames_->currentIndex();
+}
+
 int Image::width() const
 {
     assertInGuiThread();
@@ -39,6 +39,7 @@ namespace detail {
         void advance();
         boost::optional<QPixmap> current() const;
         boost::optional<QPixmap> first() const;
+        int currentIndex() const;
 
     private:
         void processOffset();
@@ -75,6 +76,9 @@ public:
     int width() const;
     int height() const;
     bool animated() const;
+    /// Index of the frame returned by pixmapOrLoad, changes as the GIF timer
+    /// advances animated images.
+    int currentFrameIndex() const;
 
     bool operator==(const Image &image) = delete;
     bool operator!=(const Image &image) = delete;
@@ -153,6 +153,26 @@ public:
         return full;
     }
 
+    /**
+     * @brief Remove the item at the beginning of the queue
+     *
+     * @param[out] popped the item that was removed
+     * @return true if an item was removed
+     */
+    bool popFront(T &popped)
+    {
+        std::unique_lock lock(this->mutex_);
+
+        if (this->buffer_.empty())
+        {
+            return false;
+        }
+
+        popped = this->buffer_.front();
+        this->buffer_.pop_front();
+        return true;
+    }
+
     /**
      * @brief Push items into beginning of queue
      *
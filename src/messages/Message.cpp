@@ -20,6 +20,26 @@ Message::Message()
 Message::~Message()
 {
     DebugCount::decrease("messages");
+    if (this->flags.has(MessageFlag::Compacted))
+    {
+        DebugCount::decrease("compacted messages");
+    }
+}
+
+bool Message::compact() const
+{
+    if (this->ircData.isEmpty() || this->elementRebuilder == nullptr ||
+        this->elementUsers > 0 || this->flags.has(MessageFlag::Compacted))
+    {
+        return false;
+    }
+
+    this->elements.clear();
+    this->elements.shrink_to_fit();
+    this->flags.set(MessageFlag::Compacted);
+    DebugCount::increase("compacted messages");
+
+    return true;
 }
 
 SBHighlight Message::getScrollBarHighlight() const
@@ -49,6 +49,8 @@ enum class MessageFlag : int64_t {
     LiveUpdatesAdd = (1LL << 28),
     LiveUpdatesRemove = (1LL << 29),
     LiveUpdatesUpdate = (1LL << 30),
+    // The elements were dropped by Message::compact
+    Compacted = (1LL << 31),
 };
 using MessageFlags = FlagsEnum<MessageFlag>;
 
@@ -82,9 +84,25 @@ struct Message : boost::noncopyable {
     // The root of the thread does not have replyThread set.
     std::shared_ptr<MessageThread> replyThread;
     uint32_t count = 1;
-    std::vector<std::unique_ptr<MessageElement>> elements;
+    // The elements are mutable so they can be dropped by compact() and
+    // rebuilt once the message is laid out again. Timestamps, badges and
+    // moderation buttons are shared with other messages.
+    mutable std::vector<std::shared_ptr<MessageElement>> elements;
+
+    // The raw IRC message this message was built from. Only messages with
+    // this and elementRebuilder set can be compacted.
+    QByteArray ircData;
+    // Rebuilds the elements dropped by compact() from ircData. Set by the
+    // provider that built the message.
+    void (*elementRebuilder)(const Message &message) = nullptr;
+    // Number of message layouts that refer to the elements
+    mutable int elementUsers = 0;
 
     ScrollbarHighlight getScrollBarHighlight() const;
+
+    // Drops the elements if no layout refers to them and they can be rebuilt
+    // from ircData. Returns true if the message was compacted.
+    bool compact() const;
 };
 
 using MessagePtr = std::shared_ptr<const Message>;
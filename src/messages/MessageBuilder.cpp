@@ -12,6 +12,7 @@
 #include "providers/twitch/TwitchAccount.hpp"
 #include "singletons/Emotes.hpp"
 #include "singletons/Resources.hpp"
+#include "singletons/Settings.hpp"
 #include "singletons/Theme.hpp"
 #include "util/FormatTime.hpp"
 #include "util/Qt.hpp"
@@ -91,7 +92,7 @@ MessagePtr makeAutomodInfoMessage(const AutomodInfoAction &action)
     auto builder = MessageBuilder();
     QString text("AutoMod: ");
 
-    builder.emplace<TimestampElement>();
+    builder.appendTimestamp();
     builder.message().flags.set(MessageFlag::PubSub);
 
     // AutoMod shield badge
@@ -192,8 +193,8 @@ std::pair<MessagePtr, MessagePtr> makeAutomodMessage(
 
     //
     // Builder for offender's message
-    builder2.emplace<TimestampElement>();
-    builder2.emplace<TwitchModerationElement>();
+    builder2.appendTimestamp();
+    builder2.append(TwitchModerationElement::instance());
     builder2.message().loginName = action.target.login;
     builder2.message().flags.set(MessageFlag::PubSub);
     builder2.message().flags.set(MessageFlag::Timeout);
@@ -232,7 +233,7 @@ MessageBuilder::MessageBuilder(SystemMessageTag, const QString &text,
                                const QTime &time)
     : MessageBuilder()
 {
-    this->emplace<TimestampElement>(time);
+    this->appendTimestamp(time);
 
     // check system message for links
     // (e.g. needed for sub ticket message in sub only mode)
@@ -268,7 +269,7 @@ MessageBuilder::MessageBuilder(TimeoutMessageTag, const QString &timeoutUser,
         usernameText == "You" || timeoutUser == usernameText;
     QString messageText;
 
-    this->emplace<TimestampElement>(time);
+    this->appendTimestamp(time);
     this->emplaceSystemTextAndUpdate(usernameText, messageText)
         ->setLink(
             {Link::UserInfo, timeoutUserIsFirst ? timeoutUser : sourceUser});
@@ -305,7 +306,7 @@ MessageBuilder::MessageBuilder(TimeoutMessageTag, const QString &username,
     QString fullText;
     QString text;
 
-    this->emplace<TimestampElement>(time);
+    this->appendTimestamp(time);
     this->emplaceSystemTextAndUpdate(username, fullText)
         ->setLink({Link::UserInfo, username});
 
@@ -351,7 +352,7 @@ MessageBuilder::MessageBuilder(const BanAction &action, uint32_t count)
 {
     auto current = getApp()->accounts->twitch.getCurrent();
 
-    this->emplace<TimestampElement>();
+    this->appendTimestamp();
     this->message().flags.set(MessageFlag::System);
     this->message().flags.set(MessageFlag::Timeout);
     this->message().timeoutUser = action.target.login;
@@ -448,7 +449,7 @@ MessageBuilder::MessageBuilder(const BanAction &action, uint32_t count)
 MessageBuilder::MessageBuilder(const UnbanAction &action)
     : MessageBuilder()
 {
-    this->emplace<TimestampElement>();
+    this->appendTimestamp();
     this->message().flags.set(MessageFlag::System);
     this->message().flags.set(MessageFlag::Untimeout);
 
@@ -470,7 +471,7 @@ MessageBuilder::MessageBuilder(const UnbanAction &action)
 MessageBuilder::MessageBuilder(const AutomodUserAction &action)
     : MessageBuilder()
 {
-    this->emplace<TimestampElement>();
+    this->appendTimestamp();
     this->message().flags.set(MessageFlag::System);
 
     QString text;
@@ -521,7 +522,7 @@ MessageBuilder::MessageBuilder(LiveUpdatesAddEmoteMessageTag /*unused*/,
     auto text =
         formatUpdatedEmoteList(platform, emoteNames, true, actor.isEmpty());
 
-    this->emplace<TimestampElement>();
+    this->appendTimestamp();
     if (!actor.isEmpty())
     {
         this->emplace<TextElement>(actor, MessageElementFlag::Username,
@@ -558,7 +559,7 @@ MessageBuilder::MessageBuilder(LiveUpdatesRemoveEmoteMessageTag /*unused*/,
     auto text =
         formatUpdatedEmoteList(platform, emoteNames, false, actor.isEmpty());
 
-    this->emplace<TimestampElement>();
+    this->appendTimestamp();
     if (!actor.isEmpty())
     {
         this->emplace<TextElement>(actor, MessageElementFlag::Username,
@@ -596,7 +597,7 @@ MessageBuilder::MessageBuilder(LiveUpdatesUpdateEmoteMessageTag /*unused*/,
     auto text = QString("renamed %1 emote %2 to %3.")
                     .arg(platform, oldEmoteName, emoteName);
 
-    this->emplace<TimestampElement>();
+    this->appendTimestamp();
     this->emplace<TextElement>(actor, MessageElementFlag::Username,
                                MessageColor::System)
         ->setLink({Link::UserInfo, actor});
@@ -622,7 +623,7 @@ MessageBuilder::MessageBuilder(LiveUpdatesUpdateEmoteSetMessageTag /*unused*/,
     auto text = QString("switched the active %1 Emote Set to \"%2\".")
                     .arg(platform, emoteSetName);
 
-    this->emplace<TimestampElement>();
+    this->appendTimestamp();
     this->emplace<TextElement>(actor, MessageElementFlag::Username,
                                MessageColor::System)
         ->setLink({Link::UserInfo, actor});
@@ -662,11 +663,16 @@ std::weak_ptr<Message> MessageBuilder::weakOf()
     return this->message_;
 }
 
-void MessageBuilder::append(std::unique_ptr<MessageElement> element)
+void MessageBuilder::append(std::shared_ptr<MessageElement> element)
 {
     this->message().elements.push_back(std::move(element));
 }
 
+void MessageBuilder::appendTimestamp(const QTime &time)
+{
+    this->append(TimestampElement::interned(time));
+}
+
 QString MessageBuilder::matchLink(const QString &string)
 {
     LinkParser linkParser(string);
@@ -725,6 +731,14 @@ void MessageBuilder::addLink(const QString &origLink,
                                    textColor)
             ->setLink(linkElement);
 
+    if (!getSettings()->linkInfoPrefetch)
+    {
+        // Resolved on hover, see ChannelView::mouseMoveEvent
+        linkMELowercase->setTooltip("No link info loaded");
+        linkMEOriginal->setTooltip("No link info loaded");
+        return;
+    }
+
     LinkResolver::getLinkInfo(
         matchedLink, nullptr,
         [weakMessage = this->weakOf(), linkMELowercase, linkMEOriginal,
@@ -752,7 +766,8 @@ void MessageBuilder::addLink(const QString &origLink,
             linkMEOriginal->setThumbnail(thumbnail);
             linkMEOriginal->setThumbnailType(
                 MessageElement::ThumbnailType::Link_Thumbnail);
-        });
+        },
+        NetworkRequestPriority::Background);
 }
 
 void MessageBuilder::addIrcMessageText(const QString &text)
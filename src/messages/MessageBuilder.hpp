@@ -86,7 +86,9 @@ public:
     MessagePtr release();
     std::weak_ptr<Message> weakOf();
 
-    void append(std::unique_ptr<MessageElement> element);
+    void append(std::shared_ptr<MessageElement> element);
+    /// Appends the timestamp shared by all messages from the same second
+    void appendTimestamp(const QTime &time = QTime::currentTime());
     QString matchLink(const QString &string);
     void addLink(const QString &origLink, const QString &matchedLink);
 
@@ -106,9 +108,9 @@ public:
         static_assert(std::is_base_of<MessageElement, T>::value,
                       "T must extend MessageElement");
 
-        auto unique = std::make_unique<T>(std::forward<Args>(args)...);
-        auto pointer = unique.get();
-        this->append(std::move(unique));
+        auto shared = std::make_shared<T>(std::forward<Args>(args)...);
+        auto pointer = shared.get();
+        this->append(std::move(shared));
         return pointer;
     }
 
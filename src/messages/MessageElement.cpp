@@ -11,8 +11,90 @@
 #include "singletons/Theme.hpp"
 #include "util/DebugCount.hpp"
 
+#include <mutex>
+#include <unordered_map>
+
 namespace chatterino {
 
+namespace {
+
+    // Hands out shared elements. An element stays in the cache as long as a
+    // message refers to it.
+    template <typename Key, typename T, typename Hash = std::hash<Key>>
+    class InternCache
+    {
+    public:
+        template <typename Make>
+        std::shared_ptr<T> get(const Key &key, Make &&make)
+        {
+            std::lock_guard lock(this->mutex_);
+
+            auto &entry = this->entries_[key];
+            if (auto element = entry.lock())
+            {
+                DebugCount::increase("shared element hits");
+                return element;
+            }
+
+            auto element = make();
+            entry = element;
+            DebugCount::increase("shared element misses");
+
+            this->removeExpired();
+            return element;
+        }
+
+    private:
+        // Entries of elements that were destroyed are removed once the
+        // cache doubled in size since the last time
+        void removeExpired()
+        {
+            if (this->entries_.size() < this->removeAt_)
+            {
+                return;
+            }
+
+            for (auto it = this->entries_.begin(); it != this->entries_.end();)
+            {
+                if (it->second.expired())
+                {
+                    it = this->entries_.erase(it);
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+
+            this->removeAt_ = std::max<size_t>(256, this->entries_.size() * 2);
+        }
+
+        std::mutex mutex_;
+        std::unordered_map<Key, std::weak_ptr<T>, Hash> entries_;
+        size_t removeAt_ = 256;
+    };
+
+    struct BadgeKey {
+        const Emote *emote;
+        MessageElementFlags flags;
+        QString tooltip;
+
+        bool operator==(const BadgeKey &other) const
+        {
+            return this->emote == other.emote && this->flags == other.flags &&
+                   this->tooltip == other.tooltip;
+        }
+    };
+
+    struct BadgeKeyHash {
+        size_t operator()(const BadgeKey &key) const
+        {
+            return std::hash<const Emote *>()(key.emote) ^ qHash(key.tooltip);
+        }
+    };
+
+}  // namespace
+
 MessageElement::MessageElement(MessageElementFlags flags)
     : flags_(flags)
 {
@@ -244,6 +326,29 @@ EmotePtr BadgeElement::getEmote() const
     return this->emote_;
 }
 
+template <typename T>
+std::shared_ptr<T> BadgeElement::interned(const EmotePtr &emote,
+                                          MessageElementFlags flags,
+                                          const QString &tooltip)
+{
+    static InternCache<BadgeKey, T, BadgeKeyHash> cache;
+
+    // The cached badge keeps the emote alive, so its address can't be reused
+    // while the entry is in use
+    return cache.get({emote.get(), flags, tooltip}, [&] {
+        auto badge = std::make_shared<T>(emote, flags);
+        badge->setTooltip(tooltip);
+        return badge;
+    });
+}
+
+template std::shared_ptr<BadgeElement> BadgeElement::interned<BadgeElement>(
+    const EmotePtr &, MessageElementFlags, const QString &);
+template std::shared_ptr<ModBadgeElement> BadgeElement::interned<
+    ModBadgeElement>(const EmotePtr &, MessageElementFlags, const QString &);
+template std::shared_ptr<VipBadgeElement> BadgeElement::interned<
+    VipBadgeElement>(const EmotePtr &, MessageElementFlags, const QString &);
+
 MessageLayoutElement *BadgeElement::makeImageLayoutElement(
     const ImagePtr &image, const QSize &size)
 {
@@ -574,9 +679,7 @@ void SingleLineTextElement::addToContainer(MessageLayoutContainer &container,
 TimestampElement::TimestampElement(QTime time)
     : MessageElement(MessageElementFlag::Timestamp)
     , time_(time)
-    , element_(this->formatTime(time))
 {
-    assert(this->element_ != nullptr);
 }
 
 void TimestampElement::addToContainer(MessageLayoutContainer &container,
@@ -584,8 +687,13 @@ void TimestampElement::addToContainer(MessageLayoutContainer &container,
 {
     if (flags.hasAny(this->getFlags()))
     {
-        if (getSettings()->timestampFormat != this->format_)
+        if (!this->element_ ||
+            getSettings()->timestampFormat != this->format_)
         {
+            if (this->element_)
+            {
+                this->previousElements_.push_back(std::move(this->element_));
+            }
             this->format_ = getSettings()->timestampFormat.getValue();
             this->element_.reset(this->formatTime(this->time_));
         }
@@ -604,12 +712,36 @@ TextElement *TimestampElement::formatTime(const QTime &time)
                            MessageColor::System, FontStyle::ChatMedium);
 }
 
+std::shared_ptr<TimestampElement> TimestampElement::interned(const QTime &time)
+{
+    static InternCache<int, TimestampElement> cache;
+
+    // Messages from the same second share their timestamp, unless the format
+    // shows milliseconds ("z" or "zzz"). Messages built before switching to
+    // such a format keep showing whole seconds.
+    auto msecs = time.msecsSinceStartOfDay();
+    if (!getSettings()->timestampFormat.getValue().contains('z'))
+    {
+        msecs -= msecs % 1000;
+    }
+    return cache.get(msecs, [msecs] {
+        return std::make_shared<TimestampElement>(
+            QTime::fromMSecsSinceStartOfDay(msecs));
+    });
+}
+
 // TWITCH MODERATION
 TwitchModerationElement::TwitchModerationElement()
     : MessageElement(MessageElementFlag::ModeratorTools)
 {
 }
 
+std::shared_ptr<TwitchModerationElement> TwitchModerationElement::instance()
+{
+    static auto element = std::make_shared<TwitchModerationElement>();
+    return element;
+}
+
 void TwitchModerationElement::addToContainer(MessageLayoutContainer &container,
                                              MessageElementFlags flags)
 {
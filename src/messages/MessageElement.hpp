@@ -331,6 +331,14 @@ public:
 
     EmotePtr getEmote() const;
 
+    /// Returns a badge shared by all messages with the same emote, flags and
+    /// tooltip. T is BadgeElement, ModBadgeElement or VipBadgeElement.
+    /// The returned badge must not be modified.
+    template <typename T>
+    static std::shared_ptr<T> interned(const EmotePtr &emote,
+                                       MessageElementFlags flags,
+                                       const QString &tooltip);
+
 protected:
     virtual MessageLayoutElement *makeImageLayoutElement(const ImagePtr &image,
                                                          const QSize &size);
@@ -383,9 +391,17 @@ public:
 
     TextElement *formatTime(const QTime &time);
 
+    /// Returns the timestamp shared by all messages from the same second, or
+    /// from the same millisecond if the timestamp format shows milliseconds
+    static std::shared_ptr<TimestampElement> interned(const QTime &time);
+
 private:
     QTime time_;
+    // Formatted on the first layout and whenever the format changes
     std::unique_ptr<TextElement> element_;
+    // Layouts of other messages sharing this timestamp can still refer to
+    // the elements of previous formats until they're laid out again
+    std::vector<std::unique_ptr<TextElement>> previousElements_;
     QString format_;
 };
 
@@ -398,6 +414,10 @@ public:
 
     void addToContainer(MessageLayoutContainer &container,
                         MessageElementFlags flags) override;
+
+    /// The moderation buttons are read from the settings when they're laid
+    /// out, so all messages share one element
+    static std::shared_ptr<TwitchModerationElement> instance();
 };
 
 // Forces a linebreak
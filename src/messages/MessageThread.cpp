@@ -3,6 +3,7 @@
 #include "messages/Message.hpp"
 #include "util/DebugCount.hpp"
 
+#include <algorithm>
 #include <utility>
 
 namespace chatterino {
@@ -26,6 +27,17 @@ void MessageThread::addToThread(const std::shared_ptr<const Message> &message)
 
 void MessageThread::addToThread(const std::weak_ptr<const Message> &message)
 {
+    if (this->replies_.size() == this->replies_.capacity())
+    {
+        // Drop replies that are gone before growing, so long-lived threads
+        // only keep references to messages that still exist
+        this->replies_.erase(std::remove_if(this->replies_.begin(),
+                                            this->replies_.end(),
+                                            [](const auto &reply) {
+                                                return reply.expired();
+                                            }),
+                             this->replies_.end());
+    }
     this->replies_.push_back(message);
 }
 
@@ -0,0 +1,159 @@
+#include "messages/MessageThreadStore.hpp"
+
+#include "messages/Message.hpp"
+#include "messages/MessageThread.hpp"
+
+namespace chatterino {
+
+namespace {
+
+    bool isPinned(const Message & /*message*/)
+    {
+        return false;
+    }
+
+    // A thread with live replies is still reachable through them. Evicting it
+    // would let the next reply create a second thread for the same root.
+    bool isPinned(const MessageThread &thread)
+    {
+        return thread.liveCount() > 0;
+    }
+
+}  // namespace
+
+template <typename T>
+void MessageThreadStore::Index<T>::insert(const QString &id,
+                                          std::weak_ptr<T> value, size_t limit)
+{
+    auto it = this->entries.find(id);
+    if (it != this->entries.end())
+    {
+        // Keep the position of the existing entry
+        it->second.value = std::move(value);
+        return;
+    }
+
+    // Make room before inserting, so the new entry is never evicted. Pinned
+    // entries are moved to the back, each at most once per insertion.
+    size_t kept = 0;
+    while (this->order.size() >= limit && kept < this->order.size())
+    {
+        auto [oldId, oldSequence] = std::move(this->order.front());
+        this->order.pop_front();
+
+        auto oldIt = this->entries.find(oldId);
+        if (oldIt == this->entries.end() ||
+            oldIt->second.sequence != oldSequence)
+        {
+            continue;
+        }
+
+        auto old = oldIt->second.value.lock();
+        if (old && isPinned(*old))
+        {
+            oldIt->second.sequence = this->nextSequence++;
+            this->order.emplace_back(std::move(oldId),
+                                     oldIt->second.sequence);
+            kept++;
+            continue;
+        }
+
+        this->entries.erase(oldIt);
+    }
+
+    auto sequence = this->nextSequence++;
+    this->entries.emplace(id, Entry{std::move(value), sequence});
+    this->order.emplace_back(id, sequence);
+}
+
+template <typename T>
+std::shared_ptr<T> MessageThreadStore::Index<T>::find(const QString &id) const
+{
+    auto it = this->entries.find(id);
+    if (it == this->entries.end())
+    {
+        return nullptr;
+    }
+
+    return it->second.value.lock();
+}
+
+MessageThreadStore::MessageThreadStore(size_t limit)
+    : limit_(limit)
+{
+}
+
+void MessageThreadStore::addMessage(const MessagePtr &message)
+{
+    if (message->id.isEmpty())
+    {
+        return;
+    }
+
+    this->messages_.insert(message->id, message, this->limit_);
+}
+
+void MessageThreadStore::removeMessage(const MessagePtr &message)
+{
+    auto it = this->messages_.entries.find(message->id);
+    if (it != this->messages_.entries.end() &&
+        it->second.value.lock() == message)
+    {
+        this->messages_.entries.erase(it);
+    }
+
+    if (message->replyThread && message->replyThread->liveCount(message) == 0)
+    {
+        this->threads_.entries.erase(message->replyThread->rootId());
+    }
+}
+
+MessagePtr MessageThreadStore::findMessage(const QString &id) const
+{
+    return this->messages_.find(id);
+}
+
+void MessageThreadStore::addThread(const std::shared_ptr<MessageThread> &thread)
+{
+    this->threads_.insert(thread->rootId(), thread, this->limit_);
+}
+
+std::shared_ptr<MessageThread> MessageThreadStore::getThread(
+    const QString &rootId) const
+{
+    return this->threads_.find(rootId);
+}
+
+void MessageThreadStore::cleanUpThreads()
+{
+    auto &entries = this->threads_.entries;
+    for (auto it = entries.begin(), last = entries.end(); it != last;)
+    {
+        bool doErase = true;
+        if (auto thread = it->second.value.lock())
+        {
+            doErase = thread->liveCount() == 0;
+        }
+
+        if (doErase)
+        {
+            it = entries.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+size_t MessageThreadStore::messageCount() const
+{
+    return this->messages_.entries.size();
+}
+
+size_t MessageThreadStore::threadCount() const
+{
+    return this->threads_.entries.size();
+}
+
+}  // namespace chatterino
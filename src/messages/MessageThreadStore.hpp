@@ -0,0 +1,80 @@
+#pragma once
+
+#include "util/QStringHash.hpp"
+
+#include <QString>
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+
+namespace chatterino {
+
+struct Message;
+using MessagePtr = std::shared_ptr<const Message>;
+class MessageThread;
+
+/// Keeps track of a channel's reply threads and of the messages replies can
+/// refer to, both keyed by message ID.
+///
+/// Entries are removed together with the channel's message buffer through
+/// removeMessage. Each index also holds at most `limit` entries as a backstop,
+/// evicting its oldest entry when full. Threads with live replies are skipped,
+/// so the thread index only grows past `limit` while all of its threads are in
+/// use. With `limit` set to the size of the channel's buffer, eviction only
+/// drops entries removeMessage missed.
+///
+/// This class is not thread-safe.
+class MessageThreadStore
+{
+public:
+    /// `limit` should be the size of the owning channel's message buffer
+    explicit MessageThreadStore(size_t limit);
+
+    /// Makes `message` resolvable as the parent of a reply
+    void addMessage(const MessagePtr &message);
+
+    /// Removes `message` from the index. The thread it replied to is dropped
+    /// if `message` was its last live reply.
+    void removeMessage(const MessagePtr &message);
+
+    /// Returns the indexed message with the ID `id` if it's still alive
+    MessagePtr findMessage(const QString &id) const;
+
+    void addThread(const std::shared_ptr<MessageThread> &thread);
+
+    /// Returns the thread rooted at `rootId` if it's still alive
+    std::shared_ptr<MessageThread> getThread(const QString &rootId) const;
+
+    /// Removes all threads without any live replies
+    void cleanUpThreads();
+
+    size_t messageCount() const;
+    size_t threadCount() const;
+
+private:
+    template <typename T>
+    struct Index {
+        struct Entry {
+            std::weak_ptr<T> value;
+            uint64_t sequence;
+        };
+
+        std::unordered_map<QString, Entry> entries;
+        // Insertion order for eviction. Entries whose sequence doesn't match
+        // were removed, re-added or kept since and are skipped.
+        std::deque<std::pair<QString, uint64_t>> order;
+        uint64_t nextSequence = 0;
+
+        void insert(const QString &id, std::weak_ptr<T> value, size_t limit);
+        std::shared_ptr<T> find(const QString &id) const;
+    };
+
+    const size_t limit_;
+    Index<const Message> messages_;
+    Index<MessageThread> threads_;
+};
+
+}  // namespace chatterino
@@ -48,6 +48,10 @@ MessageLayout::MessageLayout(MessagePtr message)
 
 MessageLayout::~MessageLayout()
 {
+    if (this->holdsElements_)
+    {
+        this->message_->elementUsers--;
+    }
     DebugCount::decrease("message layout");
 }
 
@@ -64,7 +68,8 @@ const MessagePtr &MessageLayout::getMessagePtr() const
 // Height
 int MessageLayout::getHeight() const
 {
-    return container_->getHeight();
+    // The container is empty after releaseElements
+    return this->height_;
 }
 
 int MessageLayout::getWidth() const
@@ -140,6 +145,16 @@ void MessageLayout::actuallyLayout(int width, MessageElementFlags flags)
     bool hideSimilar = getSettings()->hideSimilar;
     bool hideReplies = !flags.has(MessageElementFlag::RepliedMessage);
 
+    if (this->message_->flags.has(MessageFlag::Compacted))
+    {
+        this->message_->elementRebuilder(*this->message_);
+    }
+    if (!this->holdsElements_)
+    {
+        this->message_->elementUsers++;
+        this->holdsElements_ = true;
+    }
+
     this->container_->begin(width, this->scale_, messageFlags);
 
     for (const auto &element : this->message_->elements)
@@ -152,8 +167,6 @@ void MessageLayout::actuallyLayout(int width, MessageElementFlags flags)
         if (this->message_->flags.has(MessageFlag::Timeout) ||
             this->message_->flags.has(MessageFlag::Untimeout))
         {
-            // This condition has been set up to execute isInStreamerMode() as the last thing
-            // as it could end up being expensive.
             if (hideModerationActions ||
                 (getSettings()->streamerModeHideModActions &&
                  isInStreamerMode()))
@@ -192,6 +205,11 @@ void MessageLayout::actuallyLayout(int width, MessageElementFlags flags)
     }
 }
 
+void MessageLayout::addAnimatedRegion(QRegion &region, int y) const
+{
+    this->container_->addAnimatedRegion(region, y);
+}
+
 // Painting
 void MessageLayout::paint(QPainter &painter, int width, int y, int messageIndex,
                           Selection &selection, bool isLastReadMessage,
@@ -218,7 +236,9 @@ void MessageLayout::paint(QPainter &painter, int width, int y, int messageIndex,
         DebugCount::increase("message drawing buffers");
     }
 
-    if (!this->bufferValid_ || !selection.isEmpty())
+    // The selection is drawn on top of the buffer, so selecting doesn't
+    // invalidate it
+    if (!this->bufferValid_)
     {
         this->updateBuffer(pixmap, messageIndex, selection);
     }
@@ -406,6 +426,20 @@ void MessageLayout::deleteBuffer()
     }
 }
 
+void MessageLayout::releaseElements()
+{
+    if (!this->holdsElements_)
+    {
+        return;
+    }
+
+    this->deleteBuffer();
+    this->container_->clear();
+    this->message_->elementUsers--;
+    this->holdsElements_ = false;
+    this->flags.set(MessageLayoutFlag::RequiresLayout);
+}
+
 void MessageLayout::deleteCache()
 {
     this->deleteBuffer();
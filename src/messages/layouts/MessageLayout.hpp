@@ -9,6 +9,8 @@
 #include <cinttypes>
 #include <memory>
 
+class QRegion;
+
 namespace chatterino {
 
 struct Message;
@@ -54,6 +56,11 @@ public:
     void invalidateBuffer();
     void deleteBuffer();
     void deleteCache();
+    // Clears the laid out elements so the message can be compacted. The
+    // height is kept until the message is laid out again.
+    void releaseElements();
+    /// Adds the areas of animated emotes showing a new frame to `region`
+    void addAnimatedRegion(QRegion &region, int y) const;
 
     // Elements
     const MessageLayoutElement *getElementAt(QPoint point);
@@ -74,6 +81,8 @@ private:
     std::shared_ptr<MessageLayoutContainer> container_;
     std::shared_ptr<QPixmap> buffer_{};
     bool bufferValid_ = false;
+    // Whether the container refers to the elements of the message
+    bool holdsElements_ = false;
 
     int height_ = 0;
 
@@ -13,6 +13,9 @@
 #include <QDebug>
 #include <QPainter>
 
+#include <algorithm>
+#include <numeric>
+
 #define COMPACT_EMOTES_OFFSET 4
 #define MAX_UNCOLLAPSED_LINES \
     (getSettings()->collpseMessagesMinLines.getValue())
@@ -55,6 +58,8 @@ void MessageLayoutContainer::clear()
 {
     this->elements_.clear();
     this->lines_.clear();
+    this->animatedElements_.clear();
+    this->elementsByX_.clear();
 
     this->height_ = 0;
     this->line_ = 0;
@@ -479,6 +484,35 @@ void MessageLayoutContainer::end()
         this->lines_.back().endIndex = this->elements_.size();
         this->lines_.back().endCharIndex = this->charIndex_;
     }
+
+    // Element positions are final at this point
+    for (const auto &element : this->elements_)
+    {
+        if (element->isAnimated())
+        {
+            this->animatedElements_.push_back(element.get());
+        }
+    }
+
+    this->elementsByX_.resize(this->elements_.size());
+    std::iota(this->elementsByX_.begin(), this->elementsByX_.end(), 0);
+    for (auto &line : this->lines_)
+    {
+        auto begin = this->elementsByX_.begin() + line.startIndex;
+        auto end = this->elementsByX_.begin() + line.endIndex;
+        // Elements are only out of order in RTL lines
+        std::stable_sort(begin, end, [this](int a, int b) {
+            return this->elements_[a]->getRect().left() <
+                   this->elements_[b]->getRect().left();
+        });
+
+        for (auto it = begin; it != end; ++it)
+        {
+            line.maxElementWidth =
+                std::max(line.maxElementWidth,
+                         this->elements_[*it]->getRect().width());
+        }
+    }
 }
 
 bool MessageLayoutContainer::canCollapse()
@@ -494,17 +528,79 @@ bool MessageLayoutContainer::isCollapsed()
 
 MessageLayoutElement *MessageLayoutContainer::getElementAt(QPoint point)
 {
-    for (std::unique_ptr<MessageLayoutElement> &element : this->elements_)
+    if (this->lines_.empty())
+    {
+        return nullptr;
+    }
+
+    auto line = this->findLine(point.y());
+    if (line == this->lines_.end())
     {
-        if (element->getRect().contains(point))
+        --line;
+    }
+
+    // Compact emotes reach slightly into the neighbouring lines, so those
+    // are checked as well. Earlier lines hold the earlier elements.
+    auto first = line == this->lines_.begin() ? line : line - 1;
+    auto last = line + 1 == this->lines_.end() ? line : line + 1;
+    for (auto it = first;; ++it)
+    {
+        auto index = this->findElementInLine(*it, point);
+        if (index != -1)
+        {
+            return this->elements_[index].get();
+        }
+
+        if (it == last)
         {
-            return element.get();
+            break;
         }
     }
 
     return nullptr;
 }
 
+std::vector<MessageLayoutContainer::Line>::const_iterator
+    MessageLayoutContainer::findLine(int y) const
+{
+    return std::lower_bound(this->lines_.begin(), this->lines_.end(), y,
+                            [](const Line &line, int y) {
+                                return line.rect.bottom() < y;
+                            });
+}
+
+int MessageLayoutContainer::findElementInLine(const Line &line,
+                                              QPoint point) const
+{
+    auto begin = this->elementsByX_.begin() + line.startIndex;
+    auto end = this->elementsByX_.begin() + line.endIndex;
+
+    // First element starting to the right of the point
+    auto it = std::upper_bound(begin, end, point.x(), [this](int x, int index) {
+        return x < this->elements_[index]->getRect().left();
+    });
+
+    // Elements only overlap for zero-width emotes, so walk back until no
+    // element of this line could reach the point anymore
+    int found = -1;
+    while (it != begin)
+    {
+        --it;
+        const auto &rect = this->elements_[*it]->getRect();
+        if (rect.left() + line.maxElementWidth <= point.x())
+        {
+            break;
+        }
+
+        if (rect.contains(point) && (found == -1 || *it < found))
+        {
+            found = *it;
+        }
+    }
+
+    return found;
+}
+
 // painting
 void MessageLayoutContainer::paintElements(QPainter &painter)
 {
@@ -522,12 +618,24 @@ void MessageLayoutContainer::paintElements(QPainter &painter)
 void MessageLayoutContainer::paintAnimatedElements(QPainter &painter,
                                                    int yOffset)
 {
-    for (const std::unique_ptr<MessageLayoutElement> &element : this->elements_)
+    for (MessageLayoutElement *element : this->animatedElements_)
     {
         element->paintAnimated(painter, yOffset);
     }
 }
 
+void MessageLayoutContainer::addAnimatedRegion(QRegion &region,
+                                               int yOffset) const
+{
+    for (MessageLayoutElement *element : this->animatedElements_)
+    {
+        if (element->hasNewAnimationFrame())
+        {
+            region += element->getRect().translated(0, yOffset);
+        }
+    }
+}
+
 void MessageLayoutContainer::paintSelection(QPainter &painter, int messageIndex,
                                             Selection &selection, int yOffset)
 {
@@ -720,49 +828,25 @@ void MessageLayoutContainer::paintSelection(QPainter &painter, int messageIndex,
 // selection
 int MessageLayoutContainer::getSelectionIndex(QPoint point)
 {
-    if (this->elements_.size() == 0)
+    if (this->elements_.size() == 0 || this->lines_.empty())
     {
         return 0;
     }
 
-    auto line = this->lines_.begin();
-
-    for (; line != this->lines_.end(); line++)
-    {
-        if (line->rect.contains(point))
-        {
-            break;
-        }
-    }
-
-    int lineStart = line == this->lines_.end() ? this->lines_.back().startIndex
-                                               : line->startIndex;
-    if (line != this->lines_.end())
+    auto line = this->findLine(point.y());
+    if (line == this->lines_.end())
     {
-        line++;
+        --line;
     }
-    int lineEnd =
-        line == this->lines_.end() ? this->elements_.size() : line->startIndex;
 
-    int index = 0;
+    // Every line knows the character index it starts at, so only the
+    // elements of this line have to be visited
+    int index = line->startCharIndex;
 
-    for (int i = 0; i < lineEnd; i++)
+    for (int i = line->startIndex; i < line->endIndex; i++)
     {
         auto &&element = this->elements_[i];
 
-        // end of line
-        if (i == lineEnd)
-        {
-            break;
-        }
-
-        // before line
-        if (i < lineStart)
-        {
-            index += element->getSelectionIndexCount();
-            continue;
-        }
-
         // this is the word
         auto rightMargin = element->hasTrailingSpace() ? this->spaceWidth_ : 0;
 
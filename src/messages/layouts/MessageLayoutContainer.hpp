@@ -7,6 +7,7 @@
 
 #include <QPoint>
 #include <QRect>
+#include <QRegion>
 
 #include <memory>
 #include <vector>
@@ -75,6 +76,9 @@ struct MessageLayoutContainer {
     // painting
     void paintElements(QPainter &painter);
     void paintAnimatedElements(QPainter &painter, int yOffset);
+    /// Adds the rects of animated elements that advanced to a new frame,
+    /// moved down by `yOffset`, to `region`
+    void addAnimatedRegion(QRegion &region, int yOffset) const;
     void paintSelection(QPainter &painter, int messageIndex,
                         Selection &selection, int yOffset);
 
@@ -94,8 +98,17 @@ private:
         int startCharIndex;
         int endCharIndex;
         QRect rect;
+        // Width of the widest element in this line, bounds how far
+        // findElementInLine has to look back
+        int maxElementWidth = 0;
     };
 
+    /// Returns the first line whose bottom is at or below `y`, or the end
+    std::vector<Line>::const_iterator findLine(int y) const;
+    /// Returns the index of the first element of `line` containing `point`,
+    /// or -1 if there is none
+    int findElementInLine(const Line &line, QPoint point) const;
+
     // helpers
     /*
     _addElement is called at two stages. first stage is the normal one where we want to add message layout elements to the container.
@@ -133,6 +146,13 @@ private:
 
     std::vector<std::unique_ptr<MessageLayoutElement>> elements_;
     std::vector<Line> lines_;
+    // Elements of elements_ that are animated, collected in end() so GIF
+    // repaints don't have to visit every element
+    std::vector<MessageLayoutElement *> animatedElements_;
+    // Indices into elements_, sorted by left edge within each line, so the
+    // element under the cursor can be found with a binary search. The
+    // elements of a line are at [Line::startIndex, Line::endIndex).
+    std::vector<int> elementsByX_;
 };
 
 }  // namespace chatterino
@@ -96,6 +96,16 @@ FlagsEnum<MessageElementFlag> MessageLayoutElement::getFlags() const
     return this->creator_.getFlags();
 }
 
+bool MessageLayoutElement::isAnimated() const
+{
+    return false;
+}
+
+bool MessageLayoutElement::hasNewAnimationFrame() const
+{
+    return false;
+}
+
 //
 // IMAGE
 //
@@ -158,10 +168,22 @@ void ImageLayoutElement::paintAnimated(QPainter &painter, int yOffset)
             auto rect = this->getRect();
             rect.moveTop(rect.y() + yOffset);
             painter.drawPixmap(QRectF(rect), *pixmap, QRectF());
+            this->paintedFrameIndex_ = this->image_->currentFrameIndex();
         }
     }
 }
 
+bool ImageLayoutElement::isAnimated() const
+{
+    return this->image_ != nullptr && this->image_->animated();
+}
+
+bool ImageLayoutElement::hasNewAnimationFrame() const
+{
+    return this->isAnimated() &&
+           this->image_->currentFrameIndex() != this->paintedFrameIndex_;
+}
+
 int ImageLayoutElement::getMouseOverIndex(const QPoint &abs) const
 {
     return 0;
@@ -50,6 +50,12 @@ public:
     virtual int getMouseOverIndex(const QPoint &abs) const = 0;
     virtual int getXFromIndex(int index) = 0;
 
+    /// Returns true if paintAnimated draws anything for this element
+    virtual bool isAnimated() const;
+    /// Returns true if the animation advanced to a different frame since
+    /// paintAnimated was last called
+    virtual bool hasNewAnimationFrame() const;
+
     const Link &getLink() const;
     const QString &getText() const;
     FlagsEnum<MessageElementFlag> getFlags() const;
@@ -80,8 +86,13 @@ protected:
     void paintAnimated(QPainter &painter, int yOffset) override;
     int getMouseOverIndex(const QPoint &abs) const override;
     int getXFromIndex(int index) override;
+    bool isAnimated() const override;
+    bool hasNewAnimationFrame() const override;
 
     ImagePtr image_;
+
+private:
+    int paintedFrameIndex_ = -1;
 };
 
 class ImageWithBackgroundLayoutElement : public ImageLayoutElement
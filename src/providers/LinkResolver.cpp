@@ -3,65 +3,278 @@
 #include "common/Common.hpp"
 #include "common/Env.hpp"
 #include "common/NetworkRequest.hpp"
+#include "common/QLogging.hpp"
 #include "messages/Image.hpp"
 #include "messages/Link.hpp"
+#include "singletons/Paths.hpp"
 #include "singletons/Settings.hpp"
+#include "util/PostToThread.hpp"
 
+#include <boost/optional.hpp>
+#include <lrucache/lrucache.hpp>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPointer>
 #include <QString>
+#include <QtConcurrent>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
 
 namespace chatterino {
+namespace {
+
+    using namespace std::chrono_literals;
+
+    // Resolved links are reused for this long, both from memory and from disk
+    constexpr auto LINK_INFO_TTL = 10min;
+    // Links the resolver couldn't resolve are tried again sooner. They're only
+    // kept in memory.
+    constexpr auto LINK_INFO_ERROR_TTL = 1min;
+    constexpr size_t LINK_INFO_CACHE_SIZE = 1000;
+    // The least recently used files are removed beyond this
+    constexpr int LINK_INFO_DISK_CACHE_SIZE = 5000;
+    // Number of files written between two prunes of the disk cache
+    constexpr int LINK_INFO_DISK_PRUNE_INTERVAL = 100;
+
+    struct ResolvedLink {
+        QString tooltip;
+        // The unshortened link, empty if the resolver failed
+        QString link;
+        QString thumbnailUrl;
+        std::chrono::steady_clock::time_point resolvedAt;
+        std::chrono::steady_clock::duration ttl = LINK_INFO_TTL;
+    };
+
+    std::mutex cacheMutex;
+    cache::lru_cache<QString, ResolvedLink> resolvedLinks(LINK_INFO_CACHE_SIZE);
+
+    std::atomic<int> diskWritesSincePrune{0};
+
+    QString diskCachePath(const QString &url)
+    {
+        auto hash = QCryptographicHash::hash(url.toUtf8(),
+                                             QCryptographicHash::Sha256);
+        return getPaths()->cacheDirectory() + "/links/" +
+               QString::fromLatin1(hash.toHex());
+    }
+
+    // Reads a resolved link from the disk cache. Runs on a worker thread.
+    boost::optional<ResolvedLink> readFromDisk(const QString &url)
+    {
+        QFile file(diskCachePath(url));
+        if (!file.exists() || !file.open(QIODevice::ReadWrite))
+        {
+            return boost::none;
+        }
+
+        auto root = QJsonDocument::fromJson(file.readAll()).object();
+        auto age = std::chrono::seconds(
+            QDateTime::currentSecsSinceEpoch() -
+            root.value("resolvedAt").toVariant().toLongLong());
+        if (age < 0s || age >= LINK_INFO_TTL)
+        {
+            file.remove();
+            return boost::none;
+        }
+
+        // The modification time orders the files for pruning
+        file.setFileTime(QDateTime::currentDateTime(),
+                         QFileDevice::FileModificationTime);
+
+        ResolvedLink resolved;
+        resolved.tooltip = root.value("tooltip").toString();
+        resolved.link = root.value("link").toString();
+        resolved.thumbnailUrl = root.value("thumbnail").toString();
+        resolved.resolvedAt = std::chrono::steady_clock::now() - age;
+        return resolved;
+    }
+
+    // Removes the least recently used files beyond LINK_INFO_DISK_CACHE_SIZE.
+    // Runs on a worker thread.
+    void pruneDiskCache()
+    {
+        QDir dir(getPaths()->cacheDirectory() + "/links");
+        auto files = dir.entryInfoList(QDir::Files, QDir::Time);
+
+        int removed = 0;
+        for (int i = LINK_INFO_DISK_CACHE_SIZE; i < files.size(); i++)
+        {
+            if (QFile::remove(files.at(i).absoluteFilePath()))
+            {
+                removed++;
+            }
+        }
+
+        qCDebug(chatterinoCache) << "Removed" << removed << "link info files";
+    }
+
+    void writeToDisk(const QString &url, const ResolvedLink &resolved)
+    {
+        QJsonObject root;
+        root.insert("tooltip", resolved.tooltip);
+        root.insert("link", resolved.link);
+        root.insert("thumbnail", resolved.thumbnailUrl);
+        root.insert("resolvedAt", QDateTime::currentSecsSinceEpoch());
+
+        QtConcurrent::run([url, bytes = QJsonDocument(root).toJson(
+                                    QJsonDocument::Compact)] {
+            QDir().mkpath(getPaths()->cacheDirectory() + "/links");
+
+            QFile file(diskCachePath(url));
+            if (file.open(QIODevice::WriteOnly))
+            {
+                file.write(bytes);
+            }
+
+            if (++diskWritesSincePrune >= LINK_INFO_DISK_PRUNE_INTERVAL)
+            {
+                diskWritesSincePrune = 0;
+                pruneDiskCache();
+            }
+        });
+    }
+
+    void invokeCallback(
+        const QString &url, const ResolvedLink &resolved,
+        const std::function<void(QString, Link, ImagePtr)> &callback)
+    {
+        ImagePtr thumbnail = nullptr;
+        if (!resolved.thumbnailUrl.isEmpty())
+        {
+            thumbnail = Image::fromUrl({resolved.thumbnailUrl});
+        }
+
+        QString linkString = url;
+        if (getSettings()->unshortLinks && !resolved.link.isEmpty())
+        {
+            linkString = resolved.link;
+        }
+
+        callback(resolved.tooltip, Link(Link::Url, linkString), thumbnail);
+    }
+
+    void resolveLink(const QString &url, QObject *caller,
+                     std::function<void(QString, Link, ImagePtr)> callback,
+                     NetworkRequestPriority priority)
+    {
+        // Concurrent lookups of the same link share one request, see
+        // NetworkRequest::execute
+        // Uncomment to test crashes
+        // QTimer::singleShot(3000, [=]() {
+        NetworkRequest(Env::get().linkResolverUrl.arg(QString::fromUtf8(
+                           QUrl::toPercentEncoding(url, "", "/:"))))
+            .caller(caller)
+            .timeout(30000)
+            .priority(priority)
+            .onSuccess([callback,
+                        url](NetworkResult result) mutable -> Outcome {
+                auto root = result.parseJson();
+                auto statusCode = root.value("status").toInt();
+
+                ResolvedLink resolved;
+                resolved.resolvedAt = std::chrono::steady_clock::now();
+                if (statusCode == 200)
+                {
+                    resolved.tooltip = root.value("tooltip").toString();
+
+                    if (root.contains("thumbnail"))
+                    {
+                        resolved.thumbnailUrl =
+                            root.value("thumbnail").toString();
+                    }
+                    resolved.link = root.value("link").toString();
+                }
+                else
+                {
+                    resolved.tooltip = root.value("message").toString();
+                    resolved.ttl = LINK_INFO_ERROR_TTL;
+                }
+                resolved.tooltip =
+                    QUrl::fromPercentEncoding(resolved.tooltip.toUtf8());
+
+                {
+                    std::lock_guard lock(cacheMutex);
+                    resolvedLinks.put(url, resolved);
+                }
+                if (statusCode == 200)
+                {
+                    writeToDisk(url, resolved);
+                }
+
+                invokeCallback(url, resolved, callback);
+
+                return Success;
+            })
+            .onError([callback, url](auto /*result*/) {
+                callback("No link info found", Link(Link::Url, url), nullptr);
+            })
+            .execute();
+        // });
+    }
+
+}  // namespace
 
 void LinkResolver::getLinkInfo(
     const QString url, QObject *caller,
-    std::function<void(QString, Link, ImagePtr)> successCallback)
+    std::function<void(QString, Link, ImagePtr)> successCallback,
+    NetworkRequestPriority priority)
 {
     if (!getSettings()->linkInfoTooltip)
     {
         successCallback("No link info loaded", Link(Link::Url, url), nullptr);
         return;
     }
-    // Uncomment to test crashes
-    // QTimer::singleShot(3000, [=]() {
-    NetworkRequest(Env::get().linkResolverUrl.arg(QString::fromUtf8(
-                       QUrl::toPercentEncoding(url, "", "/:"))))
-        .caller(caller)
-        .timeout(30000)
-        .onSuccess([successCallback,
-                    url](NetworkResult result) mutable -> Outcome {
-            auto root = result.parseJson();
-            auto statusCode = root.value("status").toInt();
-            QString response;
-            QString linkString = url;
-            ImagePtr thumbnail = nullptr;
-            if (statusCode == 200)
+
+    {
+        std::unique_lock lock(cacheMutex);
+        if (resolvedLinks.exists(url))
+        {
+            auto resolved = resolvedLinks.get(url);
+            if (std::chrono::steady_clock::now() - resolved.resolvedAt <
+                resolved.ttl)
             {
-                response = root.value("tooltip").toString();
+                lock.unlock();
+                invokeCallback(url, resolved, successCallback);
+                return;
+            }
+        }
+    }
 
-                if (root.contains("thumbnail"))
-                {
-                    thumbnail =
-                        Image::fromUrl({root.value("thumbnail").toString()});
-                }
-                if (getSettings()->unshortLinks)
-                {
-                    linkString = root.value("link").toString();
-                }
+    // Look on disk before asking the resolver
+    QPointer<QObject> callerGuard(caller);
+    QtConcurrent::run([url, caller, callerGuard,
+                       successCallback = std::move(successCallback),
+                       priority]() mutable {
+        auto resolved = readFromDisk(url);
+
+        postToThread([url, caller, callerGuard,
+                      successCallback = std::move(successCallback), priority,
+                      resolved = std::move(resolved)]() mutable {
+            if (caller != nullptr && !callerGuard)
+            {
+                return;
             }
-            else
+
+            if (!resolved)
+            {
+                resolveLink(url, caller, std::move(successCallback),
+                            priority);
+                return;
+            }
+
             {
-                response = root.value("message").toString();
+                std::lock_guard lock(cacheMutex);
+                resolvedLinks.put(url, *resolved);
             }
-            successCallback(QUrl::fromPercentEncoding(response.toUtf8()),
-                            Link(Link::Url, linkString), thumbnail);
-
-            return Success;
-        })
-        .onError([successCallback, url](auto /*result*/) {
-            successCallback("No link info found", Link(Link::Url, url),
-                            nullptr);
-        })
-        .execute();
-    // });
+            invokeCallback(url, *resolved, successCallback);
+        });
+    });
 }
 
 }  // namespace chatterino
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "common/NetworkCommon.hpp"
 #include "messages/Image.hpp"
 #include "messages/Link.hpp"
 
@@ -12,9 +13,14 @@ namespace chatterino {
 class LinkResolver
 {
 public:
+    /// Resolves the tooltip, unshortened link and thumbnail of `url`.
+    /// Resolved links are kept in memory and on disk for a while. Links found
+    /// in memory call `callback` immediately, errors are only kept in memory
+    /// and for a shorter time.
     static void getLinkInfo(
         const QString url, QObject *caller,
-        std::function<void(QString, Link, ImagePtr)> callback);
+        std::function<void(QString, Link, ImagePtr)> callback,
+        NetworkRequestPriority priority = NetworkRequestPriority::Interactive);
 };
 
 }  // namespace chatterino
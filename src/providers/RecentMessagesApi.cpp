@@ -5,6 +5,7 @@
 #include "common/Env.hpp"
 #include "common/NetworkRequest.hpp"
 #include "common/QLogging.hpp"
+#include "debug/AssertInGuiThread.hpp"
 #include "providers/twitch/IrcMessageHandler.hpp"
 #include "providers/twitch/TwitchChannel.hpp"
 #include "providers/twitch/TwitchMessageBuilder.hpp"
@@ -13,10 +14,15 @@
 #include "util/PostToThread.hpp"
 
 #include <IrcMessage>
+#include <QCoreApplication>
 #include <QJsonArray>
 #include <QJsonObject>
+#include <QTimer>
 #include <QUrl>
 
+#include <algorithm>
+#include <functional>
+
 namespace chatterino {
 
 namespace {
@@ -68,45 +74,95 @@ namespace {
         return newMessage;
     }
 
-    // Parse the IRC messages returned in JSON form into Communi messages
-    std::vector<Communi::IrcMessage *> parseRecentMessages(
-        const QJsonObject &jsonRoot)
+    // Parse the IRC messages returned in JSON form into Communi messages.
+    // Messages whose id is in `knownMessageIds` are skipped. The messages are
+    // moved to the GUI thread, where they're built.
+    std::vector<std::unique_ptr<Communi::IrcMessage>> parseRecentMessages(
+        const QJsonObject &jsonRoot,
+        const std::unordered_set<QString> &knownMessageIds)
     {
         QJsonArray jsonMessages = jsonRoot.value("messages").toArray();
-        std::vector<Communi::IrcMessage *> messages;
+        std::vector<std::unique_ptr<Communi::IrcMessage>> messages;
 
         if (jsonMessages.empty())
             return messages;
 
+        messages.reserve(jsonMessages.size());
+
         for (const auto jsonMessage : jsonMessages)
         {
             auto content = jsonMessage.toString();
             content.replace(COMBINED_FIXER, ZERO_WIDTH_JOINER);
 
-            auto message =
-                Communi::IrcMessage::fromData(content.toUtf8(), nullptr);
+            std::unique_ptr<Communi::IrcMessage> message(
+                Communi::IrcMessage::fromData(content.toUtf8(), nullptr));
+
+            if (!knownMessageIds.empty() &&
+                knownMessageIds.count(message->tag("id").toString()) != 0)
+            {
+                // Already in the channel, no need to build it again
+                continue;
+            }
 
             if (message->command() == "CLEARCHAT")
             {
-                message = convertClearchatToNotice(message);
+                message.reset(convertClearchatToNotice(message.get()));
             }
 
+            message->moveToThread(QCoreApplication::instance()->thread());
             messages.emplace_back(std::move(message));
         }
 
         return messages;
     }
 
-    // Build Communi messages retrieved from the recent messages API into
-    // proper chatterino messages.
-    std::vector<MessagePtr> buildRecentMessages(
-        std::vector<Communi::IrcMessage *> &messages, Channel *channel)
+    // Recent messages are built in chunks of this size, one chunk per event
+    // loop iteration, so that a long backlog doesn't freeze the GUI
+    constexpr size_t BUILD_CHUNK_SIZE = 100;
+
+    struct RecentMessages {
+        // Keeps the channel alive until the messages are applied, so it's
+        // never destroyed on a worker thread
+        std::shared_ptr<Channel> channel;
+        std::vector<std::unique_ptr<Communi::IrcMessage>> ircMessages;
+        QString errorCode;
+    };
+
+    struct RecentMessagesBuild {
+        std::weak_ptr<Channel> channel;
+        std::vector<std::unique_ptr<Communi::IrcMessage>> ircMessages;
+        // Index of the next message to build
+        size_t next = 0;
+        std::vector<MessagePtr> builtMessages;
+        std::function<void(const std::vector<MessagePtr> &)> done;
+    };
+
+    // Build the next chunk of Communi messages retrieved from the recent
+    // messages API into proper chatterino messages, then schedule the chunk
+    // after it. `done` is called with all built messages once the last chunk
+    // is built, unless the channel is destroyed before.
+    //
+    // Building attaches replies to the channel's threads and triggers
+    // highlights, so this must run on the GUI thread.
+    void buildRecentMessagesInChunks(
+        const std::shared_ptr<RecentMessagesBuild> &build)
     {
+        assertInGuiThread();
+
+        auto channel = build->channel.lock();
+        if (!channel)
+        {
+            return;
+        }
+
         auto &handler = IrcMessageHandler::instance();
-        std::vector<MessagePtr> allBuiltMessages;
+        auto &allBuiltMessages = build->builtMessages;
+        auto end = std::min(build->next + BUILD_CHUNK_SIZE,
+                            build->ircMessages.size());
 
-        for (auto message : messages)
+        for (; build->next < end; ++build->next)
         {
+            auto *message = build->ircMessages[build->next].get();
             if (message->tags().contains("rm-received-ts"))
             {
                 QDate msgDate =
@@ -127,16 +183,27 @@ namespace {
             }
 
             auto builtMessages = handler.parseMessageWithReply(
-                channel, message, allBuiltMessages);
+                channel.get(), message, allBuiltMessages);
 
             for (auto builtMessage : builtMessages)
             {
                 builtMessage->flags.set(MessageFlag::RecentMessage);
                 allBuiltMessages.emplace_back(builtMessage);
             }
+
+            // Not needed anymore
+            build->ircMessages[build->next].reset();
         }
 
-        return allBuiltMessages;
+        if (build->next < build->ircMessages.size())
+        {
+            QTimer::singleShot(0, [build] {
+                buildRecentMessagesInChunks(build);
+            });
+            return;
+        }
+
+        build->done(allBuiltMessages);
     }
 
     // Returns the URL to be used for querying the Recent Messages API for the
@@ -157,10 +224,10 @@ namespace {
 
 }  // namespace
 
-void RecentMessagesApi::loadRecentMessages(const QString &channelName,
-                                           std::weak_ptr<Channel> channelPtr,
-                                           ResultCallback onLoaded,
-                                           ErrorCallback onError)
+void RecentMessagesApi::loadRecentMessages(
+    const QString &channelName, std::weak_ptr<Channel> channelPtr,
+    ResultCallback onLoaded, ErrorCallback onError,
+    std::unordered_set<QString> knownMessageIds)
 {
     qCDebug(chatterinoRecentMessages)
         << "Loading recent messages for" << channelName;
@@ -168,47 +235,67 @@ void RecentMessagesApi::loadRecentMessages(const QString &channelName,
     QUrl url = constructRecentMessagesUrl(channelName);
 
     NetworkRequest(url)
-        .onSuccess([channelPtr, onLoaded](NetworkResult result) -> Outcome {
-            auto shared = channelPtr.lock();
-            if (!shared)
-                return Failure;
+        .onSuccessDecoded(
+            [channelPtr, knownMessageIds = std::move(knownMessageIds)](
+                const NetworkResult &result) {
+                RecentMessages recent;
+                recent.channel = channelPtr.lock();
+                if (!recent.channel)
+                {
+                    return recent;
+                }
 
-            qCDebug(chatterinoRecentMessages)
-                << "Successfully loaded recent messages for"
-                << shared->getName();
-
-            auto root = result.parseJson();
-            auto parsedMessages = parseRecentMessages(root);
-
-            // build the Communi messages into chatterino messages
-            auto builtMessages =
-                buildRecentMessages(parsedMessages, shared.get());
-
-            postToThread([shared = std::move(shared), root = std::move(root),
-                          messages = std::move(builtMessages),
-                          onLoaded]() mutable {
-                // Notify user about a possible gap in logs if it returned some messages
-                // but isn't currently joined to a channel
-                if (QString errorCode = root.value("error_code").toString();
-                    !errorCode.isEmpty())
+                qCDebug(chatterinoRecentMessages)
+                    << "Successfully loaded recent messages for"
+                    << recent.channel->getName();
+
+                auto root = result.parseJson();
+                recent.errorCode = root.value("error_code").toString();
+
+                recent.ircMessages = parseRecentMessages(root, knownMessageIds);
+
+                return recent;
+            },
+            [onLoaded](RecentMessages &&recent) {
+                if (!recent.channel)
                 {
-                    qCDebug(chatterinoRecentMessages)
-                        << QString("Got error from API: error_code=%1, "
-                                   "channel=%2")
-                               .arg(errorCode, shared->getName());
-                    if (errorCode == "channel_not_joined" && !messages.empty())
+                    return;
+                }
+
+                auto build = std::make_shared<RecentMessagesBuild>();
+                build->channel = recent.channel;
+                build->ircMessages = std::move(recent.ircMessages);
+                build->done = [weak = build->channel,
+                               errorCode = recent.errorCode, onLoaded](
+                                  const std::vector<MessagePtr> &messages) {
+                    auto shared = weak.lock();
+                    if (!shared)
                     {
-                        shared->addMessage(makeSystemMessage(
-                            "Message history service recovering, there may "
-                            "be gaps in the message history."));
+                        return;
                     }
-                }
 
-                onLoaded(messages);
-            });
+                    // Notify user about a possible gap in logs if it returned
+                    // some messages but isn't currently joined to a channel
+                    if (!errorCode.isEmpty())
+                    {
+                        qCDebug(chatterinoRecentMessages)
+                            << QString("Got error from API: error_code=%1, "
+                                       "channel=%2")
+                                   .arg(errorCode, shared->getName());
+                        if (errorCode == "channel_not_joined" &&
+                            !messages.empty())
+                        {
+                            shared->addMessage(makeSystemMessage(
+                                "Message history service recovering, there "
+                                "may be gaps in the message history."));
+                        }
+                    }
 
-            return Success;
-        })
+                    onLoaded(messages);
+                };
+
+                buildRecentMessagesInChunks(build);
+            })
         .onError([channelPtr, onError](NetworkResult result) {
             auto shared = channelPtr.lock();
             if (!shared)
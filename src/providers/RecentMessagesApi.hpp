@@ -1,11 +1,13 @@
 #pragma once
 
 #include "ForwardDecl.hpp"
+#include "util/QStringHash.hpp"
 
 #include <QString>
 
 #include <functional>
 #include <memory>
+#include <unordered_set>
 #include <vector>
 
 namespace chatterino {
@@ -23,11 +25,18 @@ public:
      * @param channelPtr Weak pointer to Channel to use to build messages
      * @param onLoaded Callback taking the built messages as a const std::vector<MessagePtr> &
      * @param onError Callback called when the network request fails
+     * @param knownMessageIds Ids of messages already in the channel, these
+     *                        are skipped instead of being built again
+     *
+     * The response is decoded and the IRC messages are parsed on a worker
+     * thread. They're built into messages on the GUI thread, a chunk per
+     * event loop iteration, and onLoaded and onError are called there.
+     * onLoaded isn't called if the channel is destroyed while building.
      */
-    static void loadRecentMessages(const QString &channelName,
-                                   std::weak_ptr<Channel> channelPtr,
-                                   ResultCallback onLoaded,
-                                   ErrorCallback onError);
+    static void loadRecentMessages(
+        const QString &channelName, std::weak_ptr<Channel> channelPtr,
+        ResultCallback onLoaded, ErrorCallback onError,
+        std::unordered_set<QString> knownMessageIds = {});
 };
 
 }  // namespace chatterino
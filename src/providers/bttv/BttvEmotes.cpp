@@ -150,14 +150,16 @@ void BttvEmotes::loadEmotes()
 
     NetworkRequest(QString(globalEmoteApiUrl))
         .timeout(30000)
-        .onSuccess([this](auto result) -> Outcome {
-            auto emotes = this->global_.get();
-            auto pair = parseGlobalEmotes(result.parseJsonArray(), *emotes);
-            if (pair.first)
-                this->global_.set(
-                    std::make_shared<EmoteMap>(std::move(pair.second)));
-            return pair.first;
-        })
+        .onSuccessDecoded(
+            [this](const NetworkResult &result) {
+                auto emotes = this->global_.get();
+                return parseGlobalEmotes(result.parseJsonArray(), *emotes);
+            },
+            [this](std::pair<Outcome, EmoteMap> &&pair) {
+                if (pair.first)
+                    this->global_.set(
+                        std::make_shared<EmoteMap>(std::move(pair.second)));
+            })
         .execute();
 }
 
@@ -169,32 +171,33 @@ void BttvEmotes::loadChannel(std::weak_ptr<Channel> channel,
 {
     NetworkRequest(QString(bttvChannelEmoteApiUrl) + channelId)
         .timeout(20000)
-        .onSuccess([callback = std::move(callback), channel,
-                    &channelDisplayName,
-                    manualRefresh](auto result) -> Outcome {
-            auto pair =
-                parseChannelEmotes(result.parseJson(), channelDisplayName);
-            bool hasEmotes = false;
-            if (pair.first)
-            {
-                hasEmotes = !pair.second.empty();
-                callback(std::move(pair.second));
-            }
-            if (auto shared = channel.lock(); manualRefresh)
-            {
-                if (hasEmotes)
+        .onSuccessDecoded(
+            [channelDisplayName](const NetworkResult &result) {
+                return parseChannelEmotes(result.parseJson(),
+                                          channelDisplayName);
+            },
+            [callback = std::move(callback), channel,
+             manualRefresh](std::pair<Outcome, EmoteMap> &&pair) {
+                bool hasEmotes = false;
+                if (pair.first)
                 {
-                    shared->addMessage(makeSystemMessage(
-                        "BetterTTV channel emotes reloaded."));
+                    hasEmotes = !pair.second.empty();
+                    callback(std::move(pair.second));
                 }
-                else
+                if (auto shared = channel.lock(); manualRefresh)
                 {
-                    shared->addMessage(
-                        makeSystemMessage(CHANNEL_HAS_NO_EMOTES));
+                    if (hasEmotes)
+                    {
+                        shared->addMessage(makeSystemMessage(
+                            "BetterTTV channel emotes reloaded."));
+                    }
+                    else
+                    {
+                        shared->addMessage(
+                            makeSystemMessage(CHANNEL_HAS_NO_EMOTES));
+                    }
                 }
-            }
-            return pair.first;
-        })
+            })
         .onError([channelId, channel, manualRefresh](auto result) {
             auto shared = channel.lock();
             if (!shared)
@@ -17,6 +17,13 @@ namespace {
     const QString CHANNEL_HAS_NO_EMOTES(
         "This channel has no FrankerFaceZ channel emotes.");
 
+    // Everything parsed from a room response
+    struct ChannelData {
+        EmoteMap emotes;
+        boost::optional<EmotePtr> modBadge;
+        boost::optional<EmotePtr> vipBadge;
+    };
+
     Url getEmoteLink(const QJsonObject &urls, const QString &emoteScale)
     {
         auto emote = urls.value(emoteScale);
@@ -211,14 +218,16 @@ void FfzEmotes::loadEmotes()
     NetworkRequest(url)
 
         .timeout(30000)
-        .onSuccess([this](auto result) -> Outcome {
-            auto emotes = this->emotes();
-            auto pair = parseGlobalEmotes(result.parseJson(), *emotes);
-            if (pair.first)
-                this->global_.set(
-                    std::make_shared<EmoteMap>(std::move(pair.second)));
-            return pair.first;
-        })
+        .onSuccessDecoded(
+            [this](const NetworkResult &result) {
+                auto emotes = this->emotes();
+                return parseGlobalEmotes(result.parseJson(), *emotes);
+            },
+            [this](std::pair<Outcome, EmoteMap> &&pair) {
+                if (pair.first)
+                    this->global_.set(
+                        std::make_shared<EmoteMap>(std::move(pair.second)));
+            })
         .execute();
 }
 
@@ -235,40 +244,42 @@ void FfzEmotes::loadChannel(
     NetworkRequest("https://api.frankerfacez.com/v1/room/id/" + channelId)
 
         .timeout(20000)
-        .onSuccess([emoteCallback = std::move(emoteCallback),
-                    modBadgeCallback = std::move(modBadgeCallback),
-                    vipBadgeCallback = std::move(vipBadgeCallback), channel,
-                    manualRefresh](auto result) -> Outcome {
-            auto json = result.parseJson();
-            auto emoteMap = parseChannelEmotes(json);
-            auto modBadge = parseAuthorityBadge(
-                json.value("room").toObject().value("mod_urls").toObject(),
-                "Moderator");
-            auto vipBadge = parseAuthorityBadge(
-                json.value("room").toObject().value("vip_badge").toObject(),
-                "VIP");
-
-            bool hasEmotes = !emoteMap.empty();
-
-            emoteCallback(std::move(emoteMap));
-            modBadgeCallback(std::move(modBadge));
-            vipBadgeCallback(std::move(vipBadge));
-            if (auto shared = channel.lock(); manualRefresh)
-            {
-                if (hasEmotes)
-                {
-                    shared->addMessage(makeSystemMessage(
-                        "FrankerFaceZ channel emotes reloaded."));
-                }
-                else
+        .onSuccessDecoded(
+            [](const NetworkResult &result) {
+                auto json = result.parseJson();
+                auto room = json.value("room").toObject();
+
+                ChannelData data;
+                data.emotes = parseChannelEmotes(json);
+                data.modBadge = parseAuthorityBadge(
+                    room.value("mod_urls").toObject(), "Moderator");
+                data.vipBadge = parseAuthorityBadge(
+                    room.value("vip_badge").toObject(), "VIP");
+                return data;
+            },
+            [emoteCallback = std::move(emoteCallback),
+             modBadgeCallback = std::move(modBadgeCallback),
+             vipBadgeCallback = std::move(vipBadgeCallback), channel,
+             manualRefresh](ChannelData &&data) {
+                bool hasEmotes = !data.emotes.empty();
+
+                emoteCallback(std::move(data.emotes));
+                modBadgeCallback(std::move(data.modBadge));
+                vipBadgeCallback(std::move(data.vipBadge));
+                if (auto shared = channel.lock(); manualRefresh)
                 {
-                    shared->addMessage(
-                        makeSystemMessage(CHANNEL_HAS_NO_EMOTES));
+                    if (hasEmotes)
+                    {
+                        shared->addMessage(makeSystemMessage(
+                            "FrankerFaceZ channel emotes reloaded."));
+                    }
+                    else
+                    {
+                        shared->addMessage(
+                            makeSystemMessage(CHANNEL_HAS_NO_EMOTES));
+                    }
                 }
-            }
-
-            return Success;
-        })
+            })
         .onError([channelId, channel, manualRefresh](NetworkResult result) {
             auto shared = channel.lock();
             if (!shared)
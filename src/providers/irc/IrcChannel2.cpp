@@ -51,7 +51,7 @@ void IrcChannel::sendMessage(const QString &message)
                 ->setLink({Link::JumpToChannel, this->getName()});
 
             auto now = QDateTime::currentDateTime();
-            builder.emplace<TimestampElement>(now.time());
+            builder.appendTimestamp(now.time());
             builder.message().serverReceivedTime = now;
 
             auto username = this->server()->nick();
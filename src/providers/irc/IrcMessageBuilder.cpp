@@ -61,7 +61,7 @@ MessagePtr IrcMessageBuilder::build()
     this->appendChannelName();
 
     this->message().serverReceivedTime = calculateMessageTime(this->ircMessage);
-    this->emplace<TimestampElement>(this->message().serverReceivedTime.time());
+    this->appendTimestamp(this->message().serverReceivedTime.time());
 
     this->appendUsername();
 
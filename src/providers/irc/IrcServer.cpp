@@ -314,8 +314,7 @@ void IrcServer::readConnectionMessageReceived(Communi::IrcMessage *message)
             {
                 MessageBuilder builder;
 
-                builder.emplace<TimestampElement>(
-                    calculateMessageTime(message).time());
+                builder.appendTimestamp(calculateMessageTime(message).time());
                 builder.emplace<TextElement>(message->toData(),
                                              MessageElementFlag::Text);
                 builder->flags.set(MessageFlag::Debug);
@@ -344,7 +343,7 @@ void IrcServer::sendWhisper(const QString &target, const QString &message)
 
     MessageBuilder b;
 
-    b.emplace<TimestampElement>();
+    b.appendTimestamp();
     b.emplace<TextElement>(this->nick(), MessageElementFlag::Text,
                            MessageColor::Text, FontStyle::ChatMediumBold);
     b.emplace<TextElement>("->", MessageElementFlag::Text,
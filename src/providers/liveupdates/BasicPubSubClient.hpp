@@ -1,6 +1,7 @@
 #pragma once
 
 #include "common/QLogging.hpp"
+#include "providers/liveupdates/BasicPubSubTransport.hpp"
 #include "providers/liveupdates/BasicPubSubWebsocket.hpp"
 #include "singletons/Settings.hpp"
 #include "util/DebugCount.hpp"
@@ -54,20 +55,14 @@ protected:
     {
     }
 
-    bool send(const char *payload)
+    /**
+     * Queues the payload on the shared transport, which writes queued
+     * frames in batches.
+     */
+    void send(QByteArray payload)
     {
-        liveupdates::WebsocketErrorCode ec;
-        this->websocketClient_.send(this->handle_, payload,
-                                    websocketpp::frame::opcode::text, ec);
-
-        if (ec)
-        {
-            qCDebug(chatterinoLiveupdates) << "Error sending message" << payload
-                                           << ":" << ec.message().c_str();
-            return false;
-        }
-
-        return true;
+        liveupdates::BasicPubSubTransport::instance().send(this->handle_,
+                                                           std::move(payload));
     }
 
     /**
@@ -96,8 +91,7 @@ protected:
         qCDebug(chatterinoLiveupdates) << "Subscribing to" << subscription;
         DebugCount::increase("LiveUpdates subscriptions");
 
-        QByteArray encoded = subscription.encodeSubscribe();
-        this->send(encoded);
+        this->send(subscription.encodeSubscribe());
 
         return true;
     }
@@ -116,8 +110,7 @@ protected:
         qCDebug(chatterinoLiveupdates) << "Unsubscribing from" << subscription;
         DebugCount::decrease("LiveUpdates subscriptions");
 
-        QByteArray encoded = subscription.encodeUnsubscribe();
-        this->send(encoded);
+        this->send(subscription.encodeUnsubscribe());
 
         return true;
     }
@@ -1,8 +1,8 @@
 #pragma once
 
 #include "common/QLogging.hpp"
-#include "common/Version.hpp"
 #include "providers/liveupdates/BasicPubSubClient.hpp"
+#include "providers/liveupdates/BasicPubSubTransport.hpp"
 #include "providers/liveupdates/BasicPubSubWebsocket.hpp"
 #include "providers/twitch/PubSubHelpers.hpp"
 #include "util/DebugCount.hpp"
@@ -16,10 +16,10 @@
 #include <algorithm>
 #include <atomic>
 #include <chrono>
-#include <exception>
+#include <condition_variable>
 #include <map>
 #include <memory>
-#include <thread>
+#include <mutex>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -30,6 +30,8 @@ namespace chatterino {
  * This class is the basis for connecting and interacting with
  * simple PubSub servers over the Websocket protocol.
  * It acts as a pool for connections (see BasicPubSubClient).
+ * The connections of all managers share one event loop,
+ * see liveupdates::BasicPubSubTransport.
  *
  * You can customize the clients, by creating your custom
  * client in ::createClient.
@@ -61,33 +63,6 @@ public:
     BasicPubSubManager(QString host)
         : host_(std::move(host))
     {
-        this->websocketClient_.set_access_channels(
-            websocketpp::log::alevel::all);
-        this->websocketClient_.clear_access_channels(
-            websocketpp::log::alevel::frame_payload |
-            websocketpp::log::alevel::frame_header);
-
-        this->websocketClient_.init_asio();
-
-        // SSL Handshake
-        this->websocketClient_.set_tls_init_handler([this](auto hdl) {
-            return this->onTLSInit(hdl);
-        });
-
-        this->websocketClient_.set_message_handler([this](auto hdl, auto msg) {
-            this->onMessage(hdl, msg);
-        });
-        this->websocketClient_.set_open_handler([this](auto hdl) {
-            this->onConnectionOpen(hdl);
-        });
-        this->websocketClient_.set_close_handler([this](auto hdl) {
-            this->onConnectionClose(hdl);
-        });
-        this->websocketClient_.set_fail_handler([this](auto hdl) {
-            this->onConnectionFail(hdl);
-        });
-        this->websocketClient_.set_user_agent("Chatterino/" CHATTERINO_VERSION
-                                              " (" CHATTERINO_GIT_HASH ")");
     }
 
     virtual ~BasicPubSubManager() = default;
@@ -106,37 +81,52 @@ public:
 
     void start()
     {
-        this->work_ = std::make_shared<boost::asio::io_service::work>(
-            this->websocketClient_.get_io_service());
-        this->mainThread_.reset(new std::thread([this] {
-            runThread();
-        }));
+        this->stopping_ = false;
+        this->handlers_ = std::make_shared<HandlerGuard>();
+        this->transport_.acquire();
     }
 
     void stop()
     {
         this->stopping_ = true;
 
-        for (const auto &client : this->clients_)
         {
-            client.second->close("Shutting down");
-        }
+            std::unique_lock lock(this->mutex_);
+            for (const auto &client : this->clients_)
+            {
+                client.second->close("Shutting down");
+            }
+
+            // Closing is asynchronous, and the event loop might outlive us
+            bool closed = this->connectionsDone_.wait_for(
+                lock, std::chrono::seconds(5), [this] {
+                    return this->clients_.empty() && !this->addingClient_;
+                });
 
-        this->work_.reset();
+            if (!closed)
+            {
+                qCWarning(chatterinoLiveupdates)
+                    << "Timed out waiting for" << this->clients_.size()
+                    << "connections to close, leaving them behind";
+                DebugCount::decrease("LiveUpdates connections",
+                                     int64_t(this->clients_.size()));
+                this->clients_.clear();
+            }
+        }
 
-        if (this->mainThread_->joinable())
+        // The event loop may still call into our connections once they close.
+        // Waits for a running handler, after that none of them reach us.
         {
-            this->mainThread_->join();
+            std::lock_guard lock(this->handlers_->mutex);
+            this->handlers_->detached = true;
         }
 
-        assert(this->clients_.empty());
+        this->transport_.release();
     }
 
 protected:
     using WebsocketMessagePtr =
         websocketpp::config::asio_tls_client::message_type::ptr;
-    using WebsocketContextPtr =
-        websocketpp::lib::shared_ptr<boost::asio::ssl::context>;
 
     virtual void onMessage(websocketpp::connection_hdl hdl,
                            WebsocketMessagePtr msg) = 0;
@@ -154,6 +144,7 @@ protected:
     std::shared_ptr<BasicPubSubClient<Subscription>> findClient(
         websocketpp::connection_hdl hdl)
     {
+        std::lock_guard lock(this->mutex_);
         auto clientIt = this->clients_.find(hdl);
 
         if (clientIt == this->clients_.end())
@@ -166,6 +157,7 @@ protected:
 
     void unsubscribe(const Subscription &subscription)
     {
+        std::lock_guard lock(this->mutex_);
         for (auto &client : this->clients_)
         {
             if (client.second->unsubscribe(subscription))
@@ -177,32 +169,44 @@ protected:
 
     void subscribe(const Subscription &subscription)
     {
-        if (this->trySubscribe(subscription))
         {
-            return;
+            std::lock_guard lock(this->mutex_);
+            if (this->trySubscribe(subscription))
+            {
+                return;
+            }
+
+            this->pendingSubscriptions_.emplace_back(subscription);
+            DebugCount::increase("LiveUpdates subscription backlog");
         }
 
         this->addClient();
-        this->pendingSubscriptions_.emplace_back(subscription);
-        DebugCount::increase("LiveUpdates subscription backlog");
     }
 
 private:
     void onConnectionOpen(websocketpp::connection_hdl hdl)
     {
         DebugCount::increase("LiveUpdates connections");
-        this->addingClient_ = false;
         this->diag.connectionsOpened.fetch_add(1, std::memory_order_acq_rel);
 
         this->connectBackoff_.reset();
 
-        auto client = this->createClient(this->websocketClient_, hdl);
+        std::unique_lock lock(this->mutex_);
+
+        auto client = this->createClient(this->transport_.client(), hdl);
 
         // We separate the starting from the constructor because we will want to use
         // shared_from_this
         client->start();
 
         this->clients_.emplace(hdl, client);
+        this->addingClient_ = false;
+
+        if (this->stopping_)
+        {
+            client->close("Shutting down");
+            return;
+        }
 
         auto pendingSubsToTake = std::min(this->pendingSubscriptions_.size(),
                                           client->maxSubscriptions);
@@ -226,7 +230,10 @@ private:
             pendingSubsToTake--;
         }
 
-        if (!this->pendingSubscriptions_.empty())
+        bool needsClient = !this->pendingSubscriptions_.empty();
+        lock.unlock();
+
+        if (needsClient)
         {
             this->addClient();
         }
@@ -237,7 +244,8 @@ private:
         DebugCount::increase("LiveUpdates failed connections");
         this->diag.connectionsFailed.fetch_add(1, std::memory_order_acq_rel);
 
-        if (auto conn = this->websocketClient_.get_con_from_hdl(std::move(hdl)))
+        if (auto conn =
+                this->transport_.client().get_con_from_hdl(std::move(hdl)))
         {
             qCDebug(chatterinoLiveupdates)
                 << "LiveUpdates connection attempt failed (error: "
@@ -249,13 +257,21 @@ private:
                 << "LiveUpdates connection attempt failed but we can't get the "
                    "connection from a handle.";
         }
+
+        std::lock_guard lock(this->mutex_);
         this->addingClient_ = false;
-        if (!this->pendingSubscriptions_.empty())
+        this->connectionsDone_.notify_all();
+
+        if (!this->pendingSubscriptions_.empty() && !this->stopping_)
         {
-            runAfter(this->websocketClient_.get_io_service(),
-                     this->connectBackoff_.next(), [this](auto /*timer*/) {
-                         this->addClient();
-                     });
+            runAfter(this->transport_.client().get_io_service(),
+                     this->connectBackoff_.next(),
+                     this->guarded([this](auto /*timer*/) {
+                         if (!this->stopping_)
+                         {
+                             this->addClient();
+                         }
+                     }));
         }
     }
 
@@ -265,6 +281,7 @@ private:
         DebugCount::decrease("LiveUpdates connections");
         this->diag.connectionsClosed.fetch_add(1, std::memory_order_acq_rel);
 
+        std::unique_lock lock(this->mutex_);
         auto clientIt = this->clients_.find(hdl);
 
         // If this assert goes off, there's something wrong with the connection
@@ -274,6 +291,8 @@ private:
         auto client = clientIt->second;
 
         this->clients_.erase(clientIt);
+        this->connectionsDone_.notify_all();
+        lock.unlock();
 
         client->stop();
 
@@ -286,57 +305,54 @@ private:
         }
     }
 
-    WebsocketContextPtr onTLSInit(const websocketpp::connection_hdl & /*hdl*/)
-    {
-        WebsocketContextPtr ctx(
-            new boost::asio::ssl::context(boost::asio::ssl::context::tlsv12));
-
-        try
-        {
-            ctx->set_options(boost::asio::ssl::context::default_workarounds |
-                             boost::asio::ssl::context::no_sslv2 |
-                             boost::asio::ssl::context::single_dh_use);
-        }
-        catch (const std::exception &e)
-        {
-            qCDebug(chatterinoLiveupdates)
-                << "Exception caught in OnTLSInit:" << e.what();
-        }
-
-        return ctx;
-    }
-
-    void runThread()
-    {
-        qCDebug(chatterinoLiveupdates) << "Start LiveUpdates manager thread";
-        this->websocketClient_.run();
-        qCDebug(chatterinoLiveupdates)
-            << "Done with LiveUpdates manager thread";
-    }
-
     void addClient()
     {
-        if (this->addingClient_)
+        bool expected = false;
+        if (!this->addingClient_.compare_exchange_strong(expected, true))
         {
             return;
         }
 
         qCDebug(chatterinoLiveupdates) << "Adding an additional client";
 
-        this->addingClient_ = true;
-
-        websocketpp::lib::error_code ec;
-        auto con = this->websocketClient_.get_connection(
-            this->host_.toStdString(), ec);
-
-        if (ec)
+        auto connected = this->transport_.connect(
+            this->host_, {
+                             this->guarded([this](auto hdl) {
+                                 this->onConnectionOpen(hdl);
+                             }),
+                             this->guarded([this](auto hdl) {
+                                 this->onConnectionClose(hdl);
+                             }),
+                             this->guarded([this](auto hdl) {
+                                 this->onConnectionFail(hdl);
+                             }),
+                             this->guarded([this](auto hdl, auto msg) {
+                                 this->onMessage(hdl, msg);
+                             }),
+                         });
+
+        if (!connected)
         {
-            qCDebug(chatterinoLiveupdates)
-                << "Unable to establish connection:" << ec.message().c_str();
-            return;
+            std::lock_guard lock(this->mutex_);
+            this->addingClient_ = false;
+            this->connectionsDone_.notify_all();
         }
+    }
 
-        this->websocketClient_.connect(con);
+    /// Wraps a handler for the event loop so it does nothing once the
+    /// manager stopped
+    template <typename Handler>
+    auto guarded(Handler handler)
+    {
+        return [guard = this->handlers_,
+                handler = std::move(handler)](auto &&...args) {
+            std::lock_guard lock(guard->mutex);
+            if (guard->detached)
+            {
+                return;
+            }
+            handler(std::forward<decltype(args)>(args)...);
+        };
     }
 
     bool trySubscribe(const Subscription &subscription)
@@ -351,6 +367,24 @@ private:
         return false;
     }
 
+    liveupdates::BasicPubSubTransport &transport_ =
+        liveupdates::BasicPubSubTransport::instance();
+
+    // Shared with every handler given to the event loop. Handlers run while
+    // holding the mutex, stop() sets detached so none of them outlive us.
+    // It's recursive, because closing a connection from a handler can
+    // call the close handler right away.
+    struct HandlerGuard {
+        std::recursive_mutex mutex;
+        bool detached{false};
+    };
+    std::shared_ptr<HandlerGuard> handlers_ = std::make_shared<HandlerGuard>();
+
+    // Guards clients_ and pendingSubscriptions_, which are used from the
+    // event loop and from the callers of subscribe and unsubscribe
+    std::mutex mutex_;
+    std::condition_variable connectionsDone_;
+
     std::map<liveupdates::WebsocketHandle,
              std::shared_ptr<BasicPubSubClient<Subscription>>,
              std::owner_less<liveupdates::WebsocketHandle>>
@@ -360,14 +394,9 @@ private:
     std::atomic<bool> addingClient_{false};
     ExponentialBackoff<5> connectBackoff_{std::chrono::milliseconds(1000)};
 
-    std::shared_ptr<boost::asio::io_service::work> work_{nullptr};
-
-    liveupdates::WebsocketClient websocketClient_;
-    std::unique_ptr<std::thread> mainThread_;
-
     const QString host_;
 
-    bool stopping_{false};
+    std::atomic<bool> stopping_{false};
 };
 
 }  // namespace chatterino
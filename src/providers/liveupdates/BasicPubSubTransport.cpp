@@ -0,0 +1,212 @@
+#include "providers/liveupdates/BasicPubSubTransport.hpp"
+
+#include "common/QLogging.hpp"
+#include "common/Version.hpp"
+#include "providers/twitch/PubSubHelpers.hpp"
+#include "util/DebugCount.hpp"
+
+#include <exception>
+
+namespace chatterino {
+
+namespace liveupdates {
+
+    BasicPubSubTransport &BasicPubSubTransport::instance()
+    {
+        // Leaked on purpose, there's no safe point to join the thread on exit
+        static auto *transport = new BasicPubSubTransport;
+        return *transport;
+    }
+
+    BasicPubSubTransport::BasicPubSubTransport()
+    {
+        this->client_.set_access_channels(websocketpp::log::alevel::all);
+        this->client_.clear_access_channels(
+            websocketpp::log::alevel::frame_payload |
+            websocketpp::log::alevel::frame_header);
+
+        this->client_.init_asio();
+
+        this->tlsContext_ = std::make_shared<boost::asio::ssl::context>(
+            boost::asio::ssl::context::tlsv12);
+        try
+        {
+            this->tlsContext_->set_options(
+                boost::asio::ssl::context::default_workarounds |
+                boost::asio::ssl::context::no_sslv2 |
+                boost::asio::ssl::context::single_dh_use);
+        }
+        catch (const std::exception &e)
+        {
+            qCDebug(chatterinoLiveupdates)
+                << "Exception caught while setting up TLS:" << e.what();
+        }
+
+        // All connections share one context instead of creating their own
+        this->client_.set_tls_init_handler([this](auto /*hdl*/) {
+            return this->tlsContext_;
+        });
+
+        this->client_.set_user_agent("Chatterino/" CHATTERINO_VERSION
+                                     " (" CHATTERINO_GIT_HASH ")");
+    }
+
+    void BasicPubSubTransport::acquire()
+    {
+        std::lock_guard lock(this->mutex_);
+        if (this->users_++ > 0)
+        {
+            return;
+        }
+
+        this->client_.get_io_service().reset();
+        this->work_ = std::make_shared<boost::asio::io_service::work>(
+            this->client_.get_io_service());
+        this->thread_ = std::thread([this] {
+            qCDebug(chatterinoLiveupdates) << "Start LiveUpdates thread";
+            this->client_.run();
+            qCDebug(chatterinoLiveupdates) << "Done with LiveUpdates thread";
+        });
+    }
+
+    void BasicPubSubTransport::release()
+    {
+        std::lock_guard lock(this->mutex_);
+        assert(this->users_ > 0);
+        if (--this->users_ > 0)
+        {
+            return;
+        }
+
+        this->work_.reset();
+        if (this->thread_.joinable())
+        {
+            this->thread_.join();
+        }
+    }
+
+    bool BasicPubSubTransport::connect(const QString &host, Handlers handlers)
+    {
+        WebsocketErrorCode ec;
+        auto con = this->client_.get_connection(host.toStdString(), ec);
+
+        if (ec)
+        {
+            qCDebug(chatterinoLiveupdates)
+                << "Unable to establish connection:" << ec.message().c_str();
+            return false;
+        }
+
+        con->set_open_handler(std::move(handlers.onOpen));
+        con->set_message_handler(std::move(handlers.onMessage));
+        con->set_fail_handler(
+            [this, onFail = std::move(handlers.onFail)](auto hdl) {
+                this->dropQueue(hdl);
+                onFail(hdl);
+            });
+        con->set_close_handler(
+            [this, onClose = std::move(handlers.onClose)](auto hdl) {
+                this->dropQueue(hdl);
+                onClose(hdl);
+            });
+
+        this->client_.connect(con);
+
+        return true;
+    }
+
+    void BasicPubSubTransport::send(const WebsocketHandle &handle,
+                                    QByteArray payload)
+    {
+        std::lock_guard lock(this->queuesMutex_);
+
+        auto &queue = this->queues_[handle];
+        queue.frames.push_back(std::move(payload));
+        DebugCount::increase("LiveUpdates queued frames");
+
+        if (queue.flushScheduled)
+        {
+            // Sent together with the frames already queued
+            return;
+        }
+
+        queue.flushScheduled = true;
+        this->client_.get_io_service().post([this, handle] {
+            this->flush(handle);
+        });
+    }
+
+    WebsocketClient &BasicPubSubTransport::client()
+    {
+        return this->client_;
+    }
+
+    void BasicPubSubTransport::flush(const WebsocketHandle &handle)
+    {
+        WebsocketErrorCode ec;
+        auto con = this->client_.get_con_from_hdl(handle, ec);
+
+        std::unique_lock lock(this->queuesMutex_);
+        auto it = this->queues_.find(handle);
+        if (it == this->queues_.end())
+        {
+            return;
+        }
+
+        if (ec)
+        {
+            qCDebug(chatterinoLiveupdates)
+                << "Dropping queued frames:" << ec.message().c_str();
+            DebugCount::decrease("LiveUpdates queued frames",
+                                 int64_t(it->second.frames.size()));
+            this->queues_.erase(it);
+            return;
+        }
+
+        auto &queue = it->second;
+        while (!queue.frames.empty())
+        {
+            if (con->get_buffered_amount() > MAX_BUFFERED_BYTES)
+            {
+                // Try again once the socket caught up
+                lock.unlock();
+                runAfter(this->client_.get_io_service(),
+                         std::chrono::milliseconds(50),
+                         [this, handle](auto /*timer*/) {
+                             this->flush(handle);
+                         });
+                return;
+            }
+
+            const auto &frame = queue.frames.front();
+            if (auto sendEc = con->send(frame.constData(), size_t(frame.size()),
+                                        websocketpp::frame::opcode::text))
+            {
+                qCDebug(chatterinoLiveupdates)
+                    << "Error sending message" << frame << ":"
+                    << sendEc.message().c_str();
+            }
+            queue.frames.pop_front();
+            DebugCount::decrease("LiveUpdates queued frames");
+        }
+
+        queue.flushScheduled = false;
+    }
+
+    void BasicPubSubTransport::dropQueue(const WebsocketHandle &handle)
+    {
+        std::lock_guard lock(this->queuesMutex_);
+        auto it = this->queues_.find(handle);
+        if (it == this->queues_.end())
+        {
+            return;
+        }
+
+        DebugCount::decrease("LiveUpdates queued frames",
+                             int64_t(it->second.frames.size()));
+        this->queues_.erase(it);
+    }
+
+}  // namespace liveupdates
+
+}  // namespace chatterino
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "providers/liveupdates/BasicPubSubWebsocket.hpp"
+
+#include <boost/asio.hpp>
+#include <QByteArray>
+#include <QString>
+
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace chatterino {
+
+namespace liveupdates {
+
+    /**
+     * The websocket event loop shared by all BasicPubSubManagers.
+     *
+     * Every connection gets its own handlers, so a manager only ever sees the
+     * connections it opened. All connections share one thread and one TLS
+     * context.
+     *
+     * Outgoing frames are queued per connection and written in batches. While
+     * a connection's send buffer is full, its queue is held back instead of
+     * growing the buffer further.
+     */
+    class BasicPubSubTransport
+    {
+    public:
+        using MessagePtr = WebsocketClient::message_ptr;
+
+        struct Handlers {
+            std::function<void(WebsocketHandle)> onOpen;
+            std::function<void(WebsocketHandle)> onClose;
+            std::function<void(WebsocketHandle)> onFail;
+            std::function<void(WebsocketHandle, MessagePtr)> onMessage;
+        };
+
+        // Queued frames are held back while more than this many bytes are
+        // waiting to be written on a connection
+        static constexpr size_t MAX_BUFFERED_BYTES = 64 * 1024;
+
+        static BasicPubSubTransport &instance();
+
+        BasicPubSubTransport(const BasicPubSubTransport &) = delete;
+        BasicPubSubTransport(BasicPubSubTransport &&) = delete;
+        BasicPubSubTransport &operator=(const BasicPubSubTransport &) = delete;
+        BasicPubSubTransport &operator=(BasicPubSubTransport &&) = delete;
+
+        /// Starts the event loop unless it's already running.
+        /// Every acquire() must be matched by a release().
+        void acquire();
+        /// Stops the event loop once the last user released it. All
+        /// connections of the caller must be closed by then.
+        void release();
+
+        /// Opens a connection to `host`. `handlers` are only called for
+        /// this connection.
+        bool connect(const QString &host, Handlers handlers);
+
+        /// Queues `payload` as a text frame on the connection
+        void send(const WebsocketHandle &handle, QByteArray payload);
+
+        WebsocketClient &client();
+
+    private:
+        struct SendQueue {
+            std::deque<QByteArray> frames;
+            bool flushScheduled{false};
+        };
+
+        BasicPubSubTransport();
+
+        void flush(const WebsocketHandle &handle);
+        void dropQueue(const WebsocketHandle &handle);
+
+        WebsocketClient client_;
+        std::shared_ptr<boost::asio::ssl::context> tlsContext_;
+
+        std::mutex mutex_;
+        size_t users_{0};
+        std::shared_ptr<boost::asio::io_service::work> work_;
+        std::thread thread_;
+
+        std::mutex queuesMutex_;
+        std::map<WebsocketHandle, SendQueue, std::owner_less<WebsocketHandle>>
+            queues_;
+    };
+
+}  // namespace liveupdates
+
+}  // namespace chatterino
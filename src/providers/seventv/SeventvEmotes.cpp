@@ -44,6 +44,12 @@ struct CreateEmoteResult {
     bool hasImages;
 };
 
+// Everything parsed from a user response
+struct ChannelEmotes {
+    EmoteMap emotes;
+    SeventvEmotes::ChannelInfo info{};
+};
+
 EmotePtr cachedOrMake(Emote &&emote, const EmoteId &id)
 {
     static std::unordered_map<EmoteId, std::weak_ptr<const Emote>> cache;
@@ -278,16 +284,19 @@ void SeventvEmotes::loadGlobalEmotes()
 
     NetworkRequest(API_URL_GLOBAL_EMOTE_SET, NetworkRequestType::Get)
         .timeout(30000)
-        .onSuccess([this](const NetworkResult &result) -> Outcome {
-            QJsonArray parsedEmotes = result.parseJson()["emotes"].toArray();
-
-            auto emoteMap = parseEmotes(parsedEmotes, true);
-            qCDebug(chatterinoSeventv)
-                << "Loaded" << emoteMap.size() << "7TV Global Emotes";
-            this->global_.set(std::make_shared<EmoteMap>(std::move(emoteMap)));
-
-            return Success;
-        })
+        .onSuccessDecoded(
+            [](const NetworkResult &result) {
+                QJsonArray parsedEmotes =
+                    result.parseJson()["emotes"].toArray();
+
+                return std::make_shared<const EmoteMap>(
+                    parseEmotes(parsedEmotes, true));
+            },
+            [this](std::shared_ptr<const EmoteMap> &&emoteMap) {
+                qCDebug(chatterinoSeventv)
+                    << "Loaded" << emoteMap->size() << "7TV Global Emotes";
+                this->global_.set(std::move(emoteMap));
+            })
         .onError([](const NetworkResult &result) {
             qCWarning(chatterinoSeventv)
                 << "Couldn't load 7TV global emotes" << result.getData();
@@ -304,59 +313,71 @@ void SeventvEmotes::loadChannelEmotes(
 
     NetworkRequest(API_URL_USER.arg(channelId), NetworkRequestType::Get)
         .timeout(20000)
-        .onSuccess([callback = std::move(callback), channel, channelId,
-                    manualRefresh](const NetworkResult &result) -> Outcome {
-            auto json = result.parseJson();
-            auto emoteSet = json["emote_set"].toObject();
-            auto parsedEmotes = emoteSet["emotes"].toArray();
-
-            auto emoteMap = parseEmotes(parsedEmotes, false);
-            bool hasEmotes = !emoteMap.empty();
+        .onSuccessDecoded(
+            [](const NetworkResult &result) {
+                auto json = result.parseJson();
+                auto emoteSet = json["emote_set"].toObject();
+                auto parsedEmotes = emoteSet["emotes"].toArray();
 
-            qCDebug(chatterinoSeventv)
-                << "Loaded" << emoteMap.size() << "7TV Channel Emotes for"
-                << channelId << "manual refresh:" << manualRefresh;
-
-            if (hasEmotes)
-            {
-                auto user = json["user"].toObject();
+                ChannelEmotes channelEmotes;
+                channelEmotes.emotes = parseEmotes(parsedEmotes, false);
 
-                size_t connectionIdx = 0;
-                for (const auto &conn : user["connections"].toArray())
+                if (!channelEmotes.emotes.empty())
                 {
-                    if (conn.toObject()["platform"].toString() == "TWITCH")
+                    auto user = json["user"].toObject();
+
+                    size_t connectionIdx = 0;
+                    for (const auto &conn : user["connections"].toArray())
                     {
-                        break;
+                        if (conn.toObject()["platform"].toString() == "TWITCH")
+                        {
+                            break;
+                        }
+                        connectionIdx++;
                     }
-                    connectionIdx++;
+
+                    channelEmotes.info = {user["id"].toString(),
+                                          emoteSet["id"].toString(),
+                                          connectionIdx};
                 }
 
-                callback(std::move(emoteMap),
-                         {user["id"].toString(), emoteSet["id"].toString(),
-                          connectionIdx});
-            }
+                return channelEmotes;
+            },
+            [callback = std::move(callback), channel, channelId,
+             manualRefresh](ChannelEmotes &&channelEmotes) {
+                bool hasEmotes = !channelEmotes.emotes.empty();
 
-            auto shared = channel.lock();
-            if (!shared)
-            {
-                return Success;
-            }
+                qCDebug(chatterinoSeventv)
+                    << "Loaded" << channelEmotes.emotes.size()
+                    << "7TV Channel Emotes for" << channelId
+                    << "manual refresh:" << manualRefresh;
 
-            if (manualRefresh)
-            {
                 if (hasEmotes)
                 {
-                    shared->addMessage(
-                        makeSystemMessage("7TV channel emotes reloaded."));
+                    callback(std::move(channelEmotes.emotes),
+                             std::move(channelEmotes.info));
                 }
-                else
+
+                auto shared = channel.lock();
+                if (!shared)
                 {
-                    shared->addMessage(
-                        makeSystemMessage(CHANNEL_HAS_NO_EMOTES));
+                    return;
                 }
-            }
-            return Success;
-        })
+
+                if (manualRefresh)
+                {
+                    if (hasEmotes)
+                    {
+                        shared->addMessage(
+                            makeSystemMessage("7TV channel emotes reloaded."));
+                    }
+                    else
+                    {
+                        shared->addMessage(
+                            makeSystemMessage(CHANNEL_HAS_NO_EMOTES));
+                    }
+                }
+            })
         .onError(
             [channelId, channel, manualRefresh](const NetworkResult &result) {
                 auto shared = channel.lock();
@@ -398,18 +419,14 @@ void SeventvEmotes::loadChannelEmotes(
 }
 
 boost::optional<EmotePtr> SeventvEmotes::addEmote(
-    Atomic<std::shared_ptr<const EmoteMap>> &map,
-    const SeventvEventAPIEmoteAddDispatch &dispatch)
+    EmoteMap &map, const SeventvEventAPIEmoteAddDispatch &dispatch)
 {
-    // Check for visibility first, so we don't copy the map.
     auto emoteData = dispatch.emoteJson["data"].toObject();
     if (emoteData.empty() || !checkEmoteVisibility(emoteData))
     {
         return boost::none;
     }
 
-    // This copies the map.
-    EmoteMap updatedMap = *map.get();
     auto result = createEmote(dispatch.emoteJson, emoteData, false);
     if (!result.hasImages)
     {
@@ -419,50 +436,37 @@ boost::optional<EmotePtr> SeventvEmotes::addEmote(
         return boost::none;
     }
     auto emote = std::make_shared<const Emote>(std::move(result.emote));
-    updatedMap[result.name] = emote;
-    map.set(std::make_shared<EmoteMap>(std::move(updatedMap)));
+    map[result.name] = emote;
 
     return emote;
 }
 
 boost::optional<EmotePtr> SeventvEmotes::updateEmote(
-    Atomic<std::shared_ptr<const EmoteMap>> &map,
-    const SeventvEventAPIEmoteUpdateDispatch &dispatch)
+    EmoteMap &map, const SeventvEventAPIEmoteUpdateDispatch &dispatch)
 {
-    auto oldMap = map.get();
-    auto oldEmote = oldMap->findEmote(dispatch.emoteName, dispatch.emoteID);
-    if (oldEmote == oldMap->end())
+    auto oldEmote = map.findEmote(dispatch.emoteName, dispatch.emoteID);
+    if (oldEmote == map.end())
     {
         return boost::none;
     }
 
-    // This copies the map.
-    EmoteMap updatedMap = *map.get();
-    updatedMap.erase(oldEmote->second->name);
-
     auto emote = createUpdatedEmote(oldEmote->second, dispatch);
-    updatedMap[emote->name] = emote;
-    map.set(std::make_shared<EmoteMap>(std::move(updatedMap)));
+    map.erase(oldEmote);
+    map[emote->name] = emote;
 
     return emote;
 }
 
 boost::optional<EmotePtr> SeventvEmotes::removeEmote(
-    Atomic<std::shared_ptr<const EmoteMap>> &map,
-    const SeventvEventAPIEmoteRemoveDispatch &dispatch)
+    EmoteMap &map, const SeventvEventAPIEmoteRemoveDispatch &dispatch)
 {
-    // This copies the map.
-    EmoteMap updatedMap = *map.get();
-    auto it = updatedMap.findEmote(dispatch.emoteName, dispatch.emoteID);
-    if (it == updatedMap.end())
+    auto it = map.findEmote(dispatch.emoteName, dispatch.emoteID);
+    if (it == map.end())
     {
-        // We already copied the map at this point and are now discarding the copy.
-        // This is fine, because this case should be really rare.
         return boost::none;
     }
     auto emote = it->second;
-    updatedMap.erase(it);
-    map.set(std::make_shared<EmoteMap>(std::move(updatedMap)));
+    map.erase(it);
 
     return emote;
 }
@@ -476,19 +480,22 @@ void SeventvEmotes::getEmoteSet(
 
     NetworkRequest(API_URL_EMOTE_SET.arg(emoteSetId), NetworkRequestType::Get)
         .timeout(20000)
-        .onSuccess([callback = std::move(successCallback),
-                    emoteSetId](const NetworkResult &result) -> Outcome {
-            auto json = result.parseJson();
-            auto parsedEmotes = json["emotes"].toArray();
-
-            auto emoteMap = parseEmotes(parsedEmotes, false);
-
-            qCDebug(chatterinoSeventv) << "Loaded" << emoteMap.size()
-                                       << "7TV Emotes from" << emoteSetId;
-
-            callback(std::move(emoteMap), json["name"].toString());
-            return Success;
-        })
+        .onSuccessDecoded(
+            [](const NetworkResult &result) {
+                auto json = result.parseJson();
+                auto parsedEmotes = json["emotes"].toArray();
+
+                return std::make_pair(parseEmotes(parsedEmotes, false),
+                                      json["name"].toString());
+            },
+            [callback = std::move(successCallback),
+             emoteSetId](std::pair<EmoteMap, QString> &&emoteSet) {
+                qCDebug(chatterinoSeventv)
+                    << "Loaded" << emoteSet.first.size() << "7TV Emotes from"
+                    << emoteSetId;
+
+                callback(std::move(emoteSet.first), emoteSet.second);
+            })
         .onError([emoteSetId, callback = std::move(errorCallback)](
                      const NetworkResult &result) {
             if (result.status() == NetworkResult::timedoutStatus)
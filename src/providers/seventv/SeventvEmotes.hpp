@@ -75,36 +75,31 @@ public:
 
     /**
      * Adds an emote to the `map` if it's valid.
-     * This will _copy_ the emote map and
-     * update the `Atomic`.
+     * The map is modified in place, so that a batch of updates
+     * can be applied to a single copy.
      *
      * @return The added emote if an emote was added.
      */
     static boost::optional<EmotePtr> addEmote(
-        Atomic<std::shared_ptr<const EmoteMap>> &map,
-        const SeventvEventAPIEmoteAddDispatch &dispatch);
+        EmoteMap &map, const SeventvEventAPIEmoteAddDispatch &dispatch);
 
     /**
      * Updates an emote in this `map`.
-     * This will _copy_ the emote map and
-     * update the `Atomic`.
+     * The map is modified in place.
      *
      * @return The updated emote if any emote was updated.
      */
     static boost::optional<EmotePtr> updateEmote(
-        Atomic<std::shared_ptr<const EmoteMap>> &map,
-        const SeventvEventAPIEmoteUpdateDispatch &dispatch);
+        EmoteMap &map, const SeventvEventAPIEmoteUpdateDispatch &dispatch);
 
     /**
      * Removes an emote from this `map`.
-     * This will _copy_ the emote map and
-     * update the `Atomic`.
+     * The map is modified in place.
      *
      * @return The removed emote if any emote was removed.
      */
     static boost::optional<EmotePtr> removeEmote(
-        Atomic<std::shared_ptr<const EmoteMap>> &map,
-        const SeventvEventAPIEmoteRemoveDispatch &dispatch);
+        EmoteMap &map, const SeventvEventAPIEmoteRemoveDispatch &dispatch);
 
     /** Fetches an emote-set by its id */
     static void getEmoteSet(
@@ -5,6 +5,7 @@
 #include "controllers/accounts/AccountController.hpp"
 #include "messages/LimitedQueue.hpp"
 #include "messages/Message.hpp"
+#include "messages/MessageElement.hpp"
 #include "providers/twitch/TwitchAccount.hpp"
 #include "providers/twitch/TwitchAccountManager.hpp"
 #include "providers/twitch/TwitchChannel.hpp"
@@ -13,6 +14,7 @@
 #include "singletons/Resources.hpp"
 #include "singletons/Settings.hpp"
 #include "singletons/WindowManager.hpp"
+#include "util/DebugCount.hpp"
 #include "util/FormatTime.hpp"
 #include "util/Helpers.hpp"
 #include "util/IrcHelpers.hpp"
@@ -58,7 +60,7 @@ MessagePtr generateBannedMessage(bool confirmedBan)
     builder.message().searchText = text;
     builder.message().flags.set(MessageFlag::System);
 
-    builder.emplace<TimestampElement>();
+    builder.appendTimestamp();
     builder.emplace<TextElement>(bannedText, MessageElementFlag::Text,
                                  MessageColor::System);
     builder
@@ -212,6 +214,48 @@ float IrcMessageHandler::similarity(
     return similarityPercent;
 }
 
+void IrcMessageHandler::rebuildElements(const Message &message)
+{
+    assert(message.flags.has(MessageFlag::Compacted));
+
+    auto channel = getApp()->twitch->getChannelOrEmpty(message.channelName);
+    std::unique_ptr<Communi::IrcMessage> ircMessage(
+        Communi::IrcMessage::fromData(message.ircData, nullptr));
+    auto *privMsg =
+        dynamic_cast<Communi::IrcPrivateMessage *>(ircMessage.get());
+
+    if (!channel->isEmpty() && privMsg != nullptr)
+    {
+        QString content = privMsg->content();
+        int messageOffset = stripLeadingReplyMention(privMsg->tags(), content);
+        MessageParseArgs args;
+        TwitchMessageBuilder builder(channel.get(), privMsg, args, content,
+                                     privMsg->isAction());
+        builder.setMessageOffset(messageOffset);
+        builder.setRebuildingElements();
+        if (message.replyThread)
+        {
+            builder.setThread(message.replyThread);
+        }
+
+        auto built = builder.build();
+        message.elements = std::move(built->elements);
+    }
+
+    if (message.elements.empty())
+    {
+        // The channel was left, show what we still know
+        message.elements.push_back(
+            TimestampElement::interned(message.serverReceivedTime.time()));
+        message.elements.push_back(std::make_unique<TextElement>(
+            message.displayName + ": " + message.messageText,
+            MessageElementFlag::Text));
+    }
+
+    message.flags.unset(MessageFlag::Compacted);
+    DebugCount::decrease("compacted messages");
+}
+
 void IrcMessageHandler::setSimilarityFlags(MessagePtr msg, ChannelPtr chan)
 {
     if (getSettings()->similarityEnabled)
@@ -338,6 +382,8 @@ std::vector<MessagePtr> IrcMessageHandler::parseMessageWithReply(
         TwitchMessageBuilder builder(channel, message, args, content,
                                      privMsg->isAction());
         builder.setMessageOffset(messageOffset);
+        builder->ircData = message->toData();
+        builder->elementRebuilder = &IrcMessageHandler::rebuildElements;
 
         this->populateReply(tc, message, otherLoaded, builder);
 
@@ -368,18 +414,13 @@ void IrcMessageHandler::populateReply(
     if (const auto it = tags.find("reply-parent-msg-id"); it != tags.end())
     {
         const QString replyID = it.value().toString();
-        auto threadIt = channel->threads_.find(replyID);
-        if (threadIt != channel->threads_.end())
+        if (auto owned = channel->getReplyThread(replyID))
         {
-            auto owned = threadIt->second.lock();
-            if (owned)
-            {
-                // Thread already exists (has a reply)
-                updateReplyParticipatedStatus(tags, message->nick(), builder,
-                                              owned, false);
-                builder.setThread(owned);
-                return;
-            }
+            // Thread already exists (has a reply)
+            updateReplyParticipatedStatus(tags, message->nick(), builder,
+                                          owned, false);
+            builder.setThread(owned);
+            return;
         }
 
         MessagePtr foundMessage;
@@ -402,7 +443,7 @@ void IrcMessageHandler::populateReply(
             // which are typically the already-parsed recent messages from the
             // Recent Messages API. We could have a really old message that
             // still exists being replied to, so check for that here.
-            foundMessage = channel->findMessage(replyID);
+            foundMessage = channel->findReplyParent(replyID);
         }
 
         if (foundMessage)
@@ -487,15 +528,18 @@ void IrcMessageHandler::addMessage(Communi::IrcMessage *_message,
 
     TwitchMessageBuilder builder(chan.get(), _message, args, content, isAction);
     builder.setMessageOffset(messageOffset);
+    if (!isSub)
+    {
+        builder->ircData = _message->toData();
+        builder->elementRebuilder = &IrcMessageHandler::rebuildElements;
+    }
 
     if (const auto it = tags.find("reply-parent-msg-id"); it != tags.end())
     {
         const QString replyID = it.value().toString();
-        auto threadIt = channel->threads_.find(replyID);
-        if (threadIt != channel->threads_.end() && !threadIt->second.expired())
+        if (auto thread = channel->getReplyThread(replyID))
         {
             // Thread already exists (has a reply)
-            auto thread = threadIt->second.lock();
             updateReplyParticipatedStatus(tags, _message->nick(), builder,
                                           thread, false);
             builder.setThread(thread);
@@ -503,7 +547,7 @@ void IrcMessageHandler::addMessage(Communi::IrcMessage *_message,
         else
         {
             // Thread does not yet exist, find root reply and create thread.
-            auto root = channel->findMessage(replyID);
+            auto root = channel->findReplyParent(replyID);
             if (root)
             {
                 // Found root reply message
@@ -975,7 +1019,7 @@ std::vector<MessagePtr> IrcMessageHandler::parseNoticeMessage(
         builder.message().flags.set(MessageFlag::System);
         builder.message().flags.set(MessageFlag::DoNotTriggerNotification);
 
-        builder.emplace<TimestampElement>();
+        builder.appendTimestamp();
         builder.emplace<TextElement>(expirationText, MessageElementFlag::Text,
                                      MessageColor::System);
         builder
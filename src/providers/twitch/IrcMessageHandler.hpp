@@ -64,6 +64,11 @@ public:
                             const LimitedQueueSnapshot<MessagePtr> &messages);
     static void setSimilarityFlags(MessagePtr message, ChannelPtr channel);
 
+    // Rebuilds the elements of a message dropped by Message::compact from
+    // its IRC message. Its flags, highlight and thread are kept as they were
+    // when the message was received.
+    static void rebuildElements(const Message &message);
+
 private:
     void addMessage(Communi::IrcMessage *message, const QString &target,
                     const QString &content, TwitchIrcServer &server,
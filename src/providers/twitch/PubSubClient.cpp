@@ -137,6 +137,12 @@ void PubSubClient::handlePong()
 {
     assert(this->awaitingPong_);
 
+    auto sent = std::chrono::steady_clock::time_point(
+        std::chrono::steady_clock::duration(this->lastPingSent_));
+    this->latency_ = std::chrono::duration_cast<std::chrono::milliseconds>(
+                         std::chrono::steady_clock::now() - sent)
+                         .count();
+
     this->awaitingPong_ = false;
 }
 
@@ -158,6 +164,16 @@ std::vector<Listener> PubSubClient::getListeners() const
     return this->listeners_;
 }
 
+std::vector<QString>::size_type PubSubClient::getNumListens() const
+{
+    return this->numListens_;
+}
+
+std::chrono::milliseconds PubSubClient::getLatency() const
+{
+    return std::chrono::milliseconds(this->latency_);
+}
+
 void PubSubClient::ping()
 {
     assert(this->started_);
@@ -170,13 +186,17 @@ void PubSubClient::ping()
         return;
     }
 
+    this->lastPingSent_ =
+        std::chrono::steady_clock::now().time_since_epoch().count();
+    // Set before sending, the pong may be handled on another io thread
+    this->awaitingPong_ = true;
+
     if (!this->send(PING_PAYLOAD))
     {
+        this->awaitingPong_ = false;
         return;
     }
 
-    this->awaitingPong_ = true;
-
     auto self = this->shared_from_this();
 
     runAfter(this->websocketClient_.get_io_service(),
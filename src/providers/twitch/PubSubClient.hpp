@@ -8,6 +8,7 @@
 #include <QString>
 
 #include <atomic>
+#include <chrono>
 #include <vector>
 
 namespace chatterino {
@@ -54,6 +55,10 @@ public:
     bool isListeningToTopic(const QString &topic);
 
     std::vector<Listener> getListeners() const;
+    std::vector<QString>::size_type getNumListens() const;
+
+    /// Round trip of the last answered ping
+    std::chrono::milliseconds getLatency() const;
 
 private:
     void ping();
@@ -68,6 +73,10 @@ private:
     std::atomic<bool> awaitingPong_{false};
     std::atomic<bool> started_{false};
 
+    // Pings and pongs may be handled on different io threads
+    std::atomic<std::chrono::steady_clock::rep> lastPingSent_{0};
+    std::atomic<std::chrono::milliseconds::rep> latency_{0};
+
     const PubSubClientOptions &clientOptions_;
 };
 
@@ -9,6 +9,9 @@
 #include "util/Helpers.hpp"
 #include "util/RapidjsonHelpers.hpp"
 
+#include <QElapsedTimer>
+#include <QScopeGuard>
+
 #include <algorithm>
 #include <exception>
 #include <iostream>
@@ -491,15 +494,14 @@ void PubSub::setAccountData(QString token, QString userID)
 
 void PubSub::addClient()
 {
-    if (this->addingClient)
+    bool expected = false;
+    if (!this->addingClient.compare_exchange_strong(expected, true))
     {
         return;
     }
 
     qCDebug(chatterinoPubSub) << "Adding an additional client";
 
-    this->addingClient = true;
-
     websocketpp::lib::error_code ec;
     auto con =
         this->websocketClient.get_connection(this->host_.toStdString(), ec);
@@ -508,6 +510,7 @@ void PubSub::addClient()
     {
         qCDebug(chatterinoPubSub)
             << "Unable to establish connection:" << ec.message().c_str();
+        this->addingClient = false;
         return;
     }
 
@@ -518,24 +521,35 @@ void PubSub::start()
 {
     this->work = std::make_shared<boost::asio::io_service::work>(
         this->websocketClient.get_io_service());
-    this->mainThread.reset(
-        new std::thread(std::bind(&PubSub::runThread, this)));
+
+    auto threadCount = std::clamp(std::thread::hardware_concurrency(), 1U,
+                                  PubSub::maxIoThreads);
+    for (unsigned i = 0; i < threadCount; ++i)
+    {
+        this->ioThreads.emplace_back(std::bind(&PubSub::runThread, this));
+    }
 }
 
 void PubSub::stop()
 {
     this->stopping_ = true;
 
-    for (const auto &client : this->clients)
     {
-        client.second->close("Shutting down");
+        std::lock_guard lock(this->clientsMutex_);
+        for (const auto &client : this->clients)
+        {
+            client.second->close("Shutting down");
+        }
     }
 
     this->work.reset();
 
-    if (this->mainThread->joinable())
+    for (auto &thread : this->ioThreads)
     {
-        this->mainThread->join();
+        if (thread.joinable())
+        {
+            thread.join();
+        }
     }
 
     assert(this->clients.empty());
@@ -543,6 +557,7 @@ void PubSub::stop()
 
 void PubSub::unlistenAllModerationActions()
 {
+    std::lock_guard lock(this->clientsMutex_);
     for (const auto &p : this->clients)
     {
         const auto &client = p.second;
@@ -562,6 +577,7 @@ void PubSub::unlistenAllModerationActions()
 
 void PubSub::unlistenAutomod()
 {
+    std::lock_guard lock(this->clientsMutex_);
     for (const auto &p : this->clients)
     {
         const auto &client = p.second;
@@ -581,6 +597,7 @@ void PubSub::unlistenAutomod()
 
 void PubSub::unlistenWhispers()
 {
+    std::lock_guard lock(this->clientsMutex_);
     for (const auto &p : this->clients)
     {
         const auto &client = p.second;
@@ -680,39 +697,85 @@ void PubSub::listenToChannelPointRewards(const QString &channelID)
     this->listenToTopic(topic);
 }
 
-void PubSub::listen(PubSubListenMessage msg)
+void PubSub::listen(std::vector<QString> topics)
 {
-    if (this->tryListen(msg))
+    std::unique_lock lock(this->clientsMutex_);
+
+    struct Assignment {
+        std::shared_ptr<PubSubClient> client;
+        std::vector<QString> topics;
+    };
+    std::vector<Assignment> assignments;
+    assignments.reserve(this->clients.size());
+    for (const auto &p : this->clients)
     {
-        return;
+        assignments.push_back({p.second, {}});
     }
 
-    this->addClient();
-
-    std::copy(msg.topics.begin(), msg.topics.end(),
-              std::back_inserter(this->requests));
+    // Give every topic to the client with the fewest listens, so a busy
+    // channel shares its connection with as few others as possible
+    std::vector<QString> backlog;
+    for (auto &topic : topics)
+    {
+        Assignment *best = nullptr;
+        auto bestLoad = PubSubClient::MAX_LISTENS;
+        for (auto &assignment : assignments)
+        {
+            auto load = assignment.client->getNumListens() +
+                        assignment.topics.size();
+            if (load < bestLoad)
+            {
+                best = &assignment;
+                bestLoad = load;
+            }
+        }
 
-    DebugCount::increase("PubSub topic backlog", msg.topics.size());
-}
+        if (best == nullptr)
+        {
+            backlog.push_back(std::move(topic));
+        }
+        else
+        {
+            best->topics.push_back(std::move(topic));
+        }
+    }
 
-bool PubSub::tryListen(PubSubListenMessage msg)
-{
-    for (const auto &p : this->clients)
+    for (auto &assignment : assignments)
     {
-        const auto &client = p.second;
-        if (auto success = client->listen(msg); success)
+        if (assignment.topics.empty())
         {
-            this->registerNonce(msg.nonce, {
-                                               client,
-                                               "LISTEN",
-                                               msg.topics,
-                                               msg.topics.size(),
-                                           });
-            return true;
+            continue;
         }
+
+        PubSubListenMessage msg(std::move(assignment.topics));
+        msg.setToken(this->token_);
+
+        if (!assignment.client->listen(msg))
+        {
+            std::copy(msg.topics.begin(), msg.topics.end(),
+                      std::back_inserter(backlog));
+            continue;
+        }
+
+        this->registerNonce(msg.nonce, {
+                                           assignment.client,
+                                           "LISTEN",
+                                           msg.topics,
+                                           msg.topics.size(),
+                                       });
     }
 
-    return false;
+    if (backlog.empty())
+    {
+        return;
+    }
+
+    DebugCount::increase("PubSub topic backlog", backlog.size());
+    std::move(backlog.begin(), backlog.end(),
+              std::back_inserter(this->requests));
+
+    lock.unlock();
+    this->addClient();
 }
 
 void PubSub::registerNonce(QString nonce, NonceInfo info)
@@ -735,6 +798,7 @@ boost::optional<PubSub::NonceInfo> PubSub::findNonceInfo(QString nonce)
 
 bool PubSub::isListeningToTopic(const QString &topic)
 {
+    std::lock_guard lock(this->clientsMutex_);
     for (const auto &p : this->clients)
     {
         const auto &client = p.second;
@@ -747,11 +811,31 @@ bool PubSub::isListeningToTopic(const QString &topic)
     return false;
 }
 
+std::vector<std::chrono::milliseconds> PubSub::getClientLatencies() const
+{
+    std::lock_guard lock(this->clientsMutex_);
+
+    std::vector<std::chrono::milliseconds> latencies;
+    latencies.reserve(this->clients.size());
+    for (const auto &p : this->clients)
+    {
+        latencies.push_back(p.second->getLatency());
+    }
+
+    return latencies;
+}
+
 void PubSub::onMessage(websocketpp::connection_hdl hdl,
                        WebsocketMessagePtr websocketMessage)
 {
     this->diag.messagesReceived += 1;
 
+    QElapsedTimer dispatchTimer;
+    dispatchTimer.start();
+    auto addDispatchTime = qScopeGuard([this, &dispatchTimer] {
+        this->diag.dispatchTimeUs += dispatchTimer.nsecsElapsed() / 1000;
+    });
+
     const auto &payload =
         QString::fromStdString(websocketMessage->get_payload());
 
@@ -770,6 +854,7 @@ void PubSub::onMessage(websocketpp::connection_hdl hdl,
     switch (message.type)
     {
         case PubSubMessage::Type::Pong: {
+            std::lock_guard lock(this->clientsMutex_);
             auto clientIt = this->clients.find(hdl);
 
             // If this assert goes off, there's something wrong with the connection
@@ -779,6 +864,13 @@ void PubSub::onMessage(websocketpp::connection_hdl hdl,
             auto &client = *clientIt;
 
             client.second->handlePong();
+
+            auto latency = uint32_t(client.second->getLatency().count());
+            this->diag.lastPingLatencyMs = latency;
+            if (latency > this->diag.maxPingLatencyMs)
+            {
+                this->diag.maxPingLatencyMs = latency;
+            }
         }
         break;
 
@@ -813,10 +905,11 @@ void PubSub::onConnectionOpen(WebsocketHandle hdl)
     this->diag.connectionsOpened += 1;
 
     DebugCount::increase("PubSub connections");
-    this->addingClient = false;
 
     this->connectBackoff.reset();
 
+    std::unique_lock lock(this->clientsMutex_);
+
     auto client = std::make_shared<PubSubClient>(this->websocketClient, hdl,
                                                  this->clientOptions_);
 
@@ -845,6 +938,7 @@ void PubSub::onConnectionOpen(WebsocketHandle hdl)
     {
         qCWarning(chatterinoPubSub) << "Failed to listen to " << topicsToTake
                                     << "new topics on new client";
+        this->addingClient = false;
         return;
     }
     DebugCount::decrease("PubSub topic backlog", msg.topics.size());
@@ -856,7 +950,11 @@ void PubSub::onConnectionOpen(WebsocketHandle hdl)
                                        topicsToTake,
                                    });
 
-    if (!this->requests.empty())
+    bool needsClient = !this->requests.empty();
+    lock.unlock();
+
+    this->addingClient = false;
+    if (needsClient)
     {
         this->addClient();
     }
@@ -880,6 +978,8 @@ void PubSub::onConnectionFail(WebsocketHandle hdl)
     }
 
     this->addingClient = false;
+
+    std::unique_lock lock(this->clientsMutex_);
     if (!this->requests.empty())
     {
         runAfter(this->websocketClient.get_io_service(),
@@ -895,6 +995,8 @@ void PubSub::onConnectionClose(WebsocketHandle hdl)
     this->diag.connectionsClosed += 1;
 
     DebugCount::decrease("PubSub connections");
+
+    std::unique_lock lock(this->clientsMutex_);
     auto clientIt = this->clients.find(hdl);
 
     // If this assert goes off, there's something wrong with the connection
@@ -904,15 +1006,22 @@ void PubSub::onConnectionClose(WebsocketHandle hdl)
     auto client = clientIt->second;
 
     this->clients.erase(clientIt);
+    lock.unlock();
 
     client->stop();
 
     if (!this->stopping_)
     {
-        auto clientListeners = client->getListeners();
-        for (const auto &listener : clientListeners)
+        // Rebalance the topics of the closed client over the remaining ones
+        std::vector<QString> topics;
+        for (const auto &listener : client->getListeners())
         {
-            this->listenToTopic(listener.topic);
+            topics.push_back(listener.topic);
+        }
+
+        if (!topics.empty())
+        {
+            this->listen(std::move(topics));
         }
     }
 }
@@ -953,7 +1062,13 @@ void PubSub::handleResponse(const PubSubMessage &message)
         return;
     }
 
-    if (auto oInfo = this->findNonceInfo(message.nonce); oInfo)
+    boost::optional<NonceInfo> oInfo;
+    {
+        std::lock_guard lock(this->clientsMutex_);
+        oInfo = this->findNonceInfo(message.nonce);
+    }
+
+    if (oInfo)
     {
         const auto info = *oInfo;
         auto client = info.client.lock();
@@ -1179,10 +1294,7 @@ void PubSub::runThread()
 
 void PubSub::listenToTopic(const QString &topic)
 {
-    PubSubListenMessage msg({topic});
-    msg.setToken(this->token_);
-
-    this->listen(std::move(msg));
+    this->listen({topic});
 }
 
 }  // namespace chatterino
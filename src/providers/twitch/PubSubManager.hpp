@@ -18,6 +18,7 @@
 #include <chrono>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <thread>
 #include <unordered_map>
 #include <vector>
@@ -45,7 +46,9 @@ class PubSub
     };
 
     WebsocketClient websocketClient;
-    std::unique_ptr<std::thread> mainThread;
+    // Each connection's handlers run on its own strand, so connections are
+    // served in parallel by these threads
+    std::vector<std::thread> ioThreads;
 
     // Account credentials
     // Set from setAccount or setAccountData
@@ -55,6 +58,8 @@ class PubSub
 public:
     // The max amount of connections we may open
     static constexpr int maxConnections = 10;
+    // The max amount of threads serving the connections
+    static constexpr unsigned maxIoThreads = 4;
 
     PubSub(const QString &host,
            std::chrono::seconds pingInterval = std::chrono::seconds(15));
@@ -133,18 +138,32 @@ public:
         std::atomic<uint32_t> failedListenResponses{0};
         std::atomic<uint32_t> listenResponses{0};
         std::atomic<uint32_t> unlistenResponses{0};
+        // Ping round trip of the last pong received by any client, and the
+        // slowest one seen so far
+        std::atomic<uint32_t> lastPingLatencyMs{0};
+        std::atomic<uint32_t> maxPingLatencyMs{0};
+        // Total time spent parsing and dispatching incoming messages
+        std::atomic<uint64_t> dispatchTimeUs{0};
     } diag;
 
     void listenToTopic(const QString &topic);
 
+    /// Ping round trip of each open client
+    std::vector<std::chrono::milliseconds> getClientLatencies() const;
+
 private:
-    void listen(PubSubListenMessage msg);
-    bool tryListen(PubSubListenMessage msg);
+    // Spreads the topics over the least loaded clients, one LISTEN per
+    // client. Topics that don't fit are queued for a new client.
+    void listen(std::vector<QString> topics);
 
     bool isListeningToTopic(const QString &topic);
 
     void addClient();
     std::atomic<bool> addingClient{false};
+
+    // Guards clients, requests and nonces_, which are used from the io
+    // threads and from the callers of listenTo*
+    mutable std::mutex clientsMutex_;
     ExponentialBackoff<5> connectBackoff{std::chrono::milliseconds(1000)};
 
     State state = State::Connected;
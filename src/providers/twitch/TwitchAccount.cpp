@@ -189,6 +189,7 @@ void TwitchAccount::loadEmotes(std::weak_ptr<Channel> weakChannel)
         auto emoteData = this->emotes_.access();
         emoteData->emoteSets.clear();
         emoteData->emotes.clear();
+        this->emoteGeneration_++;
         qCDebug(chatterinoTwitch) << "Cleared emotes!";
     }
 
@@ -324,6 +325,7 @@ void TwitchAccount::loadUserstateEmotes(std::weak_ptr<Channel> weakChannel)
                               });
                     emoteData->emoteSets.emplace_back(emoteSet);
                 }
+                this->emoteGeneration_++;
 
                 if (auto channel = weakChannel.lock(); channel != nullptr)
                 {
@@ -349,6 +351,11 @@ SharedAccessGuard<const std::unordered_map<QString, EmoteMap>>
     return this->localEmotes_.accessConst();
 }
 
+uint64_t TwitchAccount::emoteGeneration() const
+{
+    return this->emoteGeneration_;
+}
+
 // AutoModActions
 void TwitchAccount::autoModAllow(const QString msgID, ChannelPtr channel)
 {
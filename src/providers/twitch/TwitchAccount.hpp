@@ -14,6 +14,7 @@
 #include <QString>
 #include <rapidjson/document.h>
 
+#include <atomic>
 #include <functional>
 #include <mutex>
 #include <set>
@@ -86,6 +87,9 @@ public:
     SharedAccessGuard<const TwitchAccountEmoteData> accessEmotes() const;
     SharedAccessGuard<const std::unordered_map<QString, EmoteMap>>
         accessLocalEmotes() const;
+    // Increased whenever the emotes or local emotes are modified. Both are
+    // modified in place, so this is what tells their versions apart.
+    uint64_t emoteGeneration() const;
 
     // Automod actions
     void autoModAllow(const QString msgID, ChannelPtr channel);
@@ -107,6 +111,7 @@ private:
     //    std::map<UserId, TwitchAccountEmoteData> emotes;
     UniqueAccess<TwitchAccountEmoteData> emotes_;
     UniqueAccess<std::unordered_map<QString, EmoteMap>> localEmotes_;
+    std::atomic<uint64_t> emoteGeneration_{0};
 };
 
 }  // namespace chatterino
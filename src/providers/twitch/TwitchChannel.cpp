@@ -56,8 +56,59 @@ namespace {
     const QString LOGIN_PROMPT_TEXT("Click here to add your account again.");
     const Link ACCOUNTS_LINK(Link::OpenAccountsPage, QString());
 
+    // 7TV emote updates arriving within this window are applied together
+    constexpr int SEVENTV_EMOTE_UPDATE_WINDOW = 250;
+
     // Maximum number of chatters to fetch when refreshing chatters
     constexpr auto MAX_CHATTERS_TO_FETCH = 5000;
+    // Even if the first page of chatters looks unchanged, walk all pages at
+    // least this often
+    constexpr int FULL_CHATTERS_REFRESH_PERIOD = 15 * 60 * 1000;
+
+    // Independent of the order, since Twitch doesn't guarantee one
+    size_t hashChatters(const std::unordered_set<QString> &chatters)
+    {
+        size_t hash = 0;
+        for (const auto &chatter : chatters)
+        {
+            hash += qHash(chatter);
+        }
+        return hash;
+    }
+
+    // Recent messages are added to the channel in chunks of this size, one
+    // chunk per event loop iteration, so that joining many channels at once
+    // doesn't freeze the GUI
+    constexpr size_t RECENT_MESSAGES_CHUNK_SIZE = 100;
+
+    // Adds messages[0, end) at the start of the channel, newest chunk first
+    void addMessagesAtStartInChunks(
+        const std::weak_ptr<Channel> &weak,
+        const std::shared_ptr<const std::vector<MessagePtr>> &messages,
+        size_t end, const std::function<void()> &done)
+    {
+        auto shared = weak.lock();
+        if (!shared)
+        {
+            return;
+        }
+
+        auto begin = end > RECENT_MESSAGES_CHUNK_SIZE
+                         ? end - RECENT_MESSAGES_CHUNK_SIZE
+                         : 0;
+        shared->addMessagesAtStart(std::vector<MessagePtr>(
+            messages->begin() + begin, messages->begin() + end));
+
+        if (begin == 0)
+        {
+            done();
+            return;
+        }
+
+        QTimer::singleShot(0, [weak, messages, begin, done] {
+            addMessagesAtStartInChunks(weak, messages, begin, done);
+        });
+    }
 }  // namespace
 
 TwitchChannel::TwitchChannel(const QString &name)
@@ -68,6 +119,7 @@ TwitchChannel::TwitchChannel(const QString &name)
     , channelUrl_("https://twitch.tv/" + name)
     , popoutPlayerUrl_("https://player.twitch.tv/?parent=twitch.tv&channel=" +
                        name)
+    , threads_(this->getMessageLimit())
     , bttvEmotes_(std::make_shared<EmoteMap>())
     , ffzEmotes_(std::make_shared<EmoteMap>())
     , seventvEmotes_(std::make_shared<EmoteMap>())
@@ -116,15 +168,28 @@ TwitchChannel::TwitchChannel(const QString &name)
                                              this->seventvEmoteSetID_);
     });
 
-    this->messageRemovedFromStart.connect([this](MessagePtr &msg) {
-        if (msg->replyThread)
+    // Keep the reply parent index in sync with the message buffer
+    this->messageAppended.connect([this](MessagePtr &msg, auto) {
+        this->threads_.addMessage(msg);
+    });
+    this->messagesAddedAtStart.connect([this](std::vector<MessagePtr> &msgs) {
+        for (const auto &msg : msgs)
         {
-            if (msg->replyThread->liveCount(msg) == 0)
-            {
-                this->threads_.erase(msg->replyThread->rootId());
-            }
+            this->threads_.addMessage(msg);
         }
     });
+    this->filledInMessages.connect([this](const std::vector<MessagePtr> &msgs) {
+        for (const auto &msg : msgs)
+        {
+            this->threads_.addMessage(msg);
+        }
+    });
+    this->messageReplaced.connect([this](size_t, MessagePtr &replacement) {
+        this->threads_.addMessage(replacement);
+    });
+    this->messageRemovedFromStart.connect([this](MessagePtr &msg) {
+        this->threads_.removeMessage(msg);
+    });
 
     // timers
 
@@ -146,6 +211,19 @@ TwitchChannel::TwitchChannel(const QString &name)
     });
     this->threadClearTimer_.start(5 * 60 * 1000);
 
+    QObject::connect(&this->messageCompactionTimer_, &QTimer::timeout,
+                     [this] {
+                         this->compactMessages();
+                     });
+    this->messageCompactionTimer_.start(60 * 1000);
+
+    this->seventvEmoteUpdateTimer_.setSingleShot(true);
+    this->seventvEmoteUpdateTimer_.setInterval(SEVENTV_EMOTE_UPDATE_WINDOW);
+    QObject::connect(&this->seventvEmoteUpdateTimer_, &QTimer::timeout,
+                     [this] {
+                         this->applySeventvEmoteUpdates();
+                     });
+
     // debugging
 #if 0
     for (int i = 0; i < 1000; i++) {
@@ -324,7 +402,7 @@ void TwitchChannel::showLoginMessage()
     builder.message().flags.set(MessageFlag::System);
     builder.message().flags.set(MessageFlag::DoNotTriggerNotification);
 
-    builder.emplace<TimestampElement>();
+    builder.appendTimestamp();
     builder.emplace<TextElement>(expirationText, MessageElementFlag::Text,
                                  MessageColor::System);
     builder
@@ -618,40 +696,125 @@ const QString &TwitchChannel::seventvEmoteSetID() const
 void TwitchChannel::addSeventvEmote(
     const SeventvEventAPIEmoteAddDispatch &dispatch)
 {
-    if (!SeventvEmotes::addEmote(this->seventvEmotes_, dispatch))
+    this->pendingSeventvEmoteUpdates_.emplace_back(dispatch);
+    if (!this->seventvEmoteUpdateTimer_.isActive())
     {
-        return;
+        this->seventvEmoteUpdateTimer_.start();
     }
-
-    this->addOrReplaceLiveUpdatesAddRemove(
-        true, "7TV", dispatch.actorName, dispatch.emoteJson["name"].toString());
 }
 
 void TwitchChannel::updateSeventvEmote(
     const SeventvEventAPIEmoteUpdateDispatch &dispatch)
 {
-    if (!SeventvEmotes::updateEmote(this->seventvEmotes_, dispatch))
+    this->pendingSeventvEmoteUpdates_.emplace_back(dispatch);
+    if (!this->seventvEmoteUpdateTimer_.isActive())
     {
-        return;
+        this->seventvEmoteUpdateTimer_.start();
     }
-
-    auto builder =
-        MessageBuilder(liveUpdatesUpdateEmoteMessage, "7TV", dispatch.actorName,
-                       dispatch.emoteName, dispatch.oldEmoteName);
-    this->addMessage(builder.release());
 }
 
 void TwitchChannel::removeSeventvEmote(
     const SeventvEventAPIEmoteRemoveDispatch &dispatch)
 {
-    auto removed = SeventvEmotes::removeEmote(this->seventvEmotes_, dispatch);
-    if (!removed)
+    this->pendingSeventvEmoteUpdates_.emplace_back(dispatch);
+    if (!this->seventvEmoteUpdateTimer_.isActive())
+    {
+        this->seventvEmoteUpdateTimer_.start();
+    }
+}
+
+void TwitchChannel::applySeventvEmoteUpdates()
+{
+    auto updates = std::move(this->pendingSeventvEmoteUpdates_);
+    this->pendingSeventvEmoteUpdates_.clear();
+
+    struct AddRemove {
+        bool isEmoteAdd;
+        QString actor;
+        std::vector<QString> emoteNames;
+    };
+    // Grouped by actor and operation, in the order they first appeared
+    std::vector<AddRemove> addedAndRemoved;
+    auto addAddRemove = [&addedAndRemoved](bool isEmoteAdd,
+                                           const QString &actor,
+                                           const QString &emoteName) {
+        for (auto &group : addedAndRemoved)
+        {
+            if (group.isEmoteAdd == isEmoteAdd && group.actor == actor)
+            {
+                group.emoteNames.push_back(emoteName);
+                return;
+            }
+        }
+        addedAndRemoved.push_back({isEmoteAdd, actor, {emoteName}});
+    };
+    std::vector<MessagePtr> renames;
+
+    // This copies the map once for the whole batch
+    auto updatedMap = *this->seventvEmotes_.get();
+    bool changed = false;
+
+    for (const auto &update : updates)
+    {
+        if (const auto *add =
+                std::get_if<SeventvEventAPIEmoteAddDispatch>(&update))
+        {
+            if (add->emoteSetID != this->seventvEmoteSetID_ ||
+                !SeventvEmotes::addEmote(updatedMap, *add))
+            {
+                continue;
+            }
+            addAddRemove(true, add->actorName,
+                         add->emoteJson["name"].toString());
+        }
+        else if (const auto *rename =
+                     std::get_if<SeventvEventAPIEmoteUpdateDispatch>(&update))
+        {
+            if (rename->emoteSetID != this->seventvEmoteSetID_ ||
+                !SeventvEmotes::updateEmote(updatedMap, *rename))
+            {
+                continue;
+            }
+            renames.push_back(MessageBuilder(liveUpdatesUpdateEmoteMessage,
+                                             "7TV", rename->actorName,
+                                             rename->emoteName,
+                                             rename->oldEmoteName)
+                                  .release());
+        }
+        else if (const auto *remove =
+                     std::get_if<SeventvEventAPIEmoteRemoveDispatch>(&update))
+        {
+            if (remove->emoteSetID != this->seventvEmoteSetID_)
+            {
+                continue;
+            }
+            auto removed = SeventvEmotes::removeEmote(updatedMap, *remove);
+            if (!removed)
+            {
+                continue;
+            }
+            addAddRemove(false, remove->actorName, removed.get()->name.string);
+        }
+        changed = true;
+    }
+
+    if (!changed)
     {
         return;
     }
 
-    this->addOrReplaceLiveUpdatesAddRemove(false, "7TV", dispatch.actorName,
-                                           removed.get()->name.string);
+    this->seventvEmotes_.set(
+        std::make_shared<const EmoteMap>(std::move(updatedMap)));
+
+    for (const auto &group : addedAndRemoved)
+    {
+        this->addOrReplaceLiveUpdatesAddRemove(group.isEmoteAdd, "7TV",
+                                               group.actor, group.emoteNames);
+    }
+    for (auto &rename : renames)
+    {
+        this->addMessage(rename);
+    }
 }
 
 void TwitchChannel::updateSeventvUser(
@@ -728,20 +891,19 @@ void TwitchChannel::updateSeventvData(const QString &newUserID,
     });
 }
 
-void TwitchChannel::addOrReplaceLiveUpdatesAddRemove(bool isEmoteAdd,
-                                                     const QString &platform,
-                                                     const QString &actor,
-                                                     const QString &emoteName)
+void TwitchChannel::addOrReplaceLiveUpdatesAddRemove(
+    bool isEmoteAdd, const QString &platform, const QString &actor,
+    const std::vector<QString> &emoteNames)
 {
     if (this->tryReplaceLastLiveUpdateAddOrRemove(
             isEmoteAdd ? MessageFlag::LiveUpdatesAdd
                        : MessageFlag::LiveUpdatesRemove,
-            platform, actor, emoteName))
+            platform, actor, emoteNames))
     {
         return;
     }
 
-    this->lastLiveUpdateEmoteNames_ = {emoteName};
+    this->lastLiveUpdateEmoteNames_ = emoteNames;
 
     MessagePtr msg;
     if (isEmoteAdd)
@@ -764,7 +926,7 @@ void TwitchChannel::addOrReplaceLiveUpdatesAddRemove(bool isEmoteAdd,
 
 bool TwitchChannel::tryReplaceLastLiveUpdateAddOrRemove(
     MessageFlag op, const QString &platform, const QString &actor,
-    const QString &emoteName)
+    const std::vector<QString> &emoteNames)
 {
     if (this->lastLiveUpdateEmotePlatform_ != platform)
     {
@@ -778,7 +940,9 @@ bool TwitchChannel::tryReplaceLastLiveUpdateAddOrRemove(
         return false;
     }
     // Update the message
-    this->lastLiveUpdateEmoteNames_.push_back(emoteName);
+    this->lastLiveUpdateEmoteNames_.insert(
+        this->lastLiveUpdateEmoteNames_.end(), emoteNames.begin(),
+        emoteNames.end());
 
     MessageBuilder replacement;
     if (op == MessageFlag::LiveUpdatesAdd)
@@ -1029,8 +1193,21 @@ void TwitchChannel::loadRecentMessages()
             if (!tc)
                 return;
 
-            tc->addMessagesAtStart(messages);
-            tc->loadingRecentMessages_.clear();
+            if (messages.empty())
+            {
+                tc->loadingRecentMessages_.clear();
+                return;
+            }
+
+            addMessagesAtStartInChunks(
+                weak, std::make_shared<const std::vector<MessagePtr>>(messages),
+                messages.size(), [weak] {
+                    if (auto shared = weak.lock())
+                    {
+                        static_cast<TwitchChannel *>(shared.get())
+                            ->loadingRecentMessages_.clear();
+                    }
+                });
         },
         [weak]() {
             auto shared = weak.lock();
@@ -1057,6 +1234,18 @@ void TwitchChannel::loadRecentMessagesReconnect()
         return;  // already loading
     }
 
+    // Only the messages we missed while disconnected need to be built
+    std::unordered_set<QString> knownMessageIds;
+    auto snapshot = this->getMessageSnapshot();
+    knownMessageIds.reserve(snapshot.size());
+    for (const auto &msg : snapshot)
+    {
+        if (!msg->id.isEmpty())
+        {
+            knownMessageIds.insert(msg->id);
+        }
+    }
+
     auto weak = weakOf<Channel>(this);
     RecentMessagesApi::loadRecentMessages(
         this->getName(), weak,
@@ -1082,7 +1271,8 @@ void TwitchChannel::loadRecentMessagesReconnect()
                 return;
 
             tc->loadingRecentMessages_.clear();
-        });
+        },
+        std::move(knownMessageIds));
 }
 
 void TwitchChannel::refreshPubSub()
@@ -1122,19 +1312,76 @@ void TwitchChannel::refreshChatters()
         }
     }
 
-    // Get chatter list via helix api
-    getHelix()->getChatters(
+    if (this->chattersRefreshInProgress_)
+    {
+        return;
+    }
+    this->chattersRefreshInProgress_ = true;
+
+    auto isFirstPage = std::make_shared<bool>(true);
+
+    // Get chatter list via helix api, applying every page as it arrives
+    getHelix()->getChattersPaged(
         this->roomId(), getApp()->accounts->twitch.getCurrent()->getUserId(),
         MAX_CHATTERS_TO_FETCH,
-        [this, weak = weakOf<Channel>(this)](auto result) {
-            if (auto shared = weak.lock())
+        [this, weak = weakOf<Channel>(this),
+         isFirstPage](const HelixChatters &chatters) {
+            auto shared = weak.lock();
+            if (!shared)
+            {
+                // The channel was closed, stop paginating
+                return false;
+            }
+
+            if (*isFirstPage)
+            {
+                *isFirstPage = false;
+
+                auto hash = hashChatters(chatters.chatters);
+                bool unchanged =
+                    chatters.total == this->chatterCount_ &&
+                    hash == this->chattersFirstPageHash_ &&
+                    this->lastFullChattersRefresh_.isValid() &&
+                    !this->lastFullChattersRefresh_.hasExpired(
+                        FULL_CHATTERS_REFRESH_PERIOD);
+                this->chattersFirstPageHash_ = hash;
+
+                if (unchanged)
+                {
+                    // Most likely nobody joined or left, so don't bother
+                    // downloading the remaining pages
+                    this->addOnlineChatters(chatters.chatters);
+                    return false;
+                }
+
+                this->beginOnlineChattersUpdate();
+            }
+
+            this->addOnlineChatters(chatters.chatters);
+            this->chatterCount_ = chatters.total;
+            return true;
+        },
+        [this, weak = weakOf<Channel>(this)](bool complete) {
+            auto shared = weak.lock();
+            if (!shared)
+            {
+                return;
+            }
+
+            this->chattersRefreshInProgress_ = false;
+            if (complete)
             {
-                this->updateOnlineChatters(result.chatters);
-                this->chatterCount_ = result.total;
+                this->finishOnlineChattersUpdate();
+                this->lastFullChattersRefresh_.start();
             }
         },
         // Refresh chatters should only be used when failing silently is an option
-        [](auto error, auto message) {});
+        [this, weak = weakOf<Channel>(this)](auto error, auto message) {
+            if (auto shared = weak.lock())
+            {
+                this->chattersRefreshInProgress_ = false;
+            }
+        });
 }
 
 void TwitchChannel::fetchDisplayName()
@@ -1166,34 +1413,45 @@ void TwitchChannel::fetchDisplayName()
 
 void TwitchChannel::addReplyThread(const std::shared_ptr<MessageThread> &thread)
 {
-    this->threads_[thread->rootId()] = thread;
+    this->threads_.addThread(thread);
+}
+
+std::shared_ptr<MessageThread> TwitchChannel::getReplyThread(
+    const QString &rootId) const
+{
+    return this->threads_.getThread(rootId);
 }
 
-const std::unordered_map<QString, std::weak_ptr<MessageThread>>
-    &TwitchChannel::threads() const
+MessagePtr TwitchChannel::findReplyParent(const QString &id) const
 {
-    return this->threads_;
+    return this->threads_.findMessage(id);
 }
 
 void TwitchChannel::cleanUpReplyThreads()
 {
-    for (auto it = this->threads_.begin(), last = this->threads_.end();
-         it != last;)
+    this->threads_.cleanUpThreads();
+}
+
+void TwitchChannel::compactMessages()
+{
+    auto minutes = getSettings()->messageCompactionAge.getValue();
+    if (minutes <= 0)
     {
-        bool doErase = true;
-        if (auto thread = it->second.lock())
-        {
-            doErase = thread->liveCount() == 0;
-        }
+        return;
+    }
 
-        if (doErase)
-        {
-            it = this->threads_.erase(it);
-        }
-        else
+    auto threshold = QDateTime::currentDateTime().addSecs(-60 * minutes);
+    auto snapshot = this->getMessageSnapshot();
+    for (size_t i = 0; i < snapshot.size(); ++i)
+    {
+        const auto &message = snapshot[i];
+        if (message->serverReceivedTime > threshold)
         {
-            ++it;
+            // The remaining messages are newer
+            break;
         }
+
+        message->compact();
     }
 }
 
@@ -1356,7 +1614,7 @@ void TwitchChannel::createClip()
             builder.message().searchText = text;
             builder.message().flags.set(MessageFlag::System);
 
-            builder.emplace<TimestampElement>();
+            builder.appendTimestamp();
             // text
             builder.emplace<TextElement>("Clip created!",
                                          MessageElementFlag::Text,
@@ -1385,7 +1643,7 @@ void TwitchChannel::createClip()
             QString text;
             builder.message().flags.set(MessageFlag::System);
 
-            builder.emplace<TimestampElement>();
+            builder.appendTimestamp();
 
             switch (error)
             {
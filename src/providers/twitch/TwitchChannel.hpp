@@ -9,6 +9,7 @@
 #include "common/Outcome.hpp"
 #include "common/UniqueAccess.hpp"
 #include "messages/MessageThread.hpp"
+#include "messages/MessageThreadStore.hpp"
 #include "providers/seventv/eventapi/SeventvEventAPIDispatch.hpp"
 #include "providers/twitch/api/Helix.hpp"
 #include "providers/twitch/ChannelPointReward.hpp"
@@ -25,6 +26,7 @@
 #include <atomic>
 #include <mutex>
 #include <unordered_map>
+#include <variant>
 
 namespace chatterino {
 
@@ -123,6 +125,8 @@ public:
     const QString &seventvUserID() const;
     const QString &seventvEmoteSetID() const;
 
+    // 7TV emote updates are collected for a short while and then applied
+    // together, see applySeventvEmoteUpdates.
     /** Adds a 7TV channel emote to this channel. */
     void addSeventvEmote(const SeventvEventAPIEmoteAddDispatch &dispatch);
     /** Updates a 7TV channel emote's name in this channel */
@@ -154,8 +158,12 @@ public:
      * TwitchChannel instance will store a weak_ptr to the thread.
      */
     void addReplyThread(const std::shared_ptr<MessageThread> &thread);
-    const std::unordered_map<QString, std::weak_ptr<MessageThread>> &threads()
-        const;
+    /// Returns the thread rooted at `rootId` if it's still alive.
+    /// Safe to call from any thread.
+    std::shared_ptr<MessageThread> getReplyThread(const QString &rootId) const;
+    /// Returns the message with the ID `id` from this channel's buffer, so a
+    /// new thread can be started for it. Safe to call from any thread.
+    MessagePtr findReplyParent(const QString &id) const;
 
     // Signals
     pajlada::Signals::NoArgSignal roomIdChanged;
@@ -189,6 +197,8 @@ private:
     void loadRecentMessagesReconnect();
     void fetchDisplayName();
     void cleanUpReplyThreads();
+    // Compacts messages older than the messageCompactionAge setting
+    void compactMessages();
     void showLoginMessage();
 
     void setLive(bool newLiveStatus);
@@ -213,12 +223,11 @@ private:
      * @param isEmoteAdd true if the emote was added, false if it was removed.
      * @param platform The platform the emote was updated on ("7TV", "BTTV", "FFZ")
      * @param actor The actor performing the update (possibly empty)
-     * @param emoteName The emote's name
+     * @param emoteNames The names of the updated emotes
      */
-    void addOrReplaceLiveUpdatesAddRemove(bool isEmoteAdd,
-                                          const QString &platform,
-                                          const QString &actor,
-                                          const QString &emoteName);
+    void addOrReplaceLiveUpdatesAddRemove(
+        bool isEmoteAdd, const QString &platform, const QString &actor,
+        const std::vector<QString> &emoteNames);
 
     /**
      * Tries to replace the last emote update message.
@@ -232,23 +241,29 @@ private:
      * @param op The emote operation (LiveUpdatesAdd or LiveUpdatesRemove)
      * @param platform The emote platform  ("7TV", "BTTV", "FFZ")
      * @param actor The actor performing the action (possibly empty)
-     * @param emoteName The updated emote's name
+     * @param emoteNames The updated emotes' names
      * @return true, if the last message was replaced
      */
-    bool tryReplaceLastLiveUpdateAddOrRemove(MessageFlag op,
-                                             const QString &platform,
-                                             const QString &actor,
-                                             const QString &emoteName);
+    bool tryReplaceLastLiveUpdateAddOrRemove(
+        MessageFlag op, const QString &platform, const QString &actor,
+        const std::vector<QString> &emoteNames);
+
+    /**
+     * Applies all queued 7TV emote updates to a single copy of the emote map
+     * and adds one message per actor and operation.
+     */
+    void applySeventvEmoteUpdates();
 
     // Data
     const QString subscriptionUrl_;
     const QString channelUrl_;
     const QString popoutPlayerUrl_;
-    int chatterCount_;
+    int chatterCount_{};
     UniqueAccess<StreamStatus> streamStatus_;
     UniqueAccess<RoomModes> roomModes_;
     std::atomic_flag loadingRecentMessages_ = ATOMIC_FLAG_INIT;
-    std::unordered_map<QString, std::weak_ptr<MessageThread>> threads_;
+    // Only used on the GUI thread, where messages are built
+    MessageThreadStore threads_;
 
 protected:
     Atomic<std::shared_ptr<const EmoteMap>> bttvEmotes_;
@@ -273,7 +288,11 @@ private:
     QString lastSentMessage_;
     QObject lifetimeGuard_;
     QTimer chattersListTimer_;
+    bool chattersRefreshInProgress_ = false;
+    size_t chattersFirstPageHash_ = 0;
+    QElapsedTimer lastFullChattersRefresh_;
     QTimer threadClearTimer_;
+    QTimer messageCompactionTimer_;
     QElapsedTimer titleRefreshedTimer_;
     QElapsedTimer clipCreationTimer_;
     bool isClipCreationInProgress{false};
@@ -303,6 +322,14 @@ private:
     /** A list of the emotes listed in the lat live emote update message. */
     std::vector<QString> lastLiveUpdateEmoteNames_;
 
+    using SeventvEmoteUpdate =
+        std::variant<SeventvEventAPIEmoteAddDispatch,
+                     SeventvEventAPIEmoteUpdateDispatch,
+                     SeventvEventAPIEmoteRemoveDispatch>;
+    /** 7TV emote updates waiting for seventvEmoteUpdateTimer_. */
+    std::vector<SeventvEmoteUpdate> pendingSeventvEmoteUpdates_;
+    QTimer seventvEmoteUpdateTimer_;
+
     pajlada::Signals::SignalHolder signalHolder_;
     std::vector<boost::signals2::scoped_connection> bSignals_;
 
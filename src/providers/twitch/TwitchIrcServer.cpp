@@ -37,8 +37,10 @@ namespace chatterino {
 
 TwitchIrcServer::TwitchIrcServer()
     : whispersChannel(new Channel("/whispers", Channel::Type::TwitchWhispers))
-    , mentionsChannel(new Channel("/mentions", Channel::Type::TwitchMentions))
-    , liveChannel(new Channel("/live", Channel::Type::TwitchLive))
+    , mentionsChannel(new Channel("/mentions", Channel::Type::TwitchMentions,
+                                  getSettings()->scrollbackAggregateLimit))
+    , liveChannel(new Channel("/live", Channel::Type::TwitchLive,
+                              getSettings()->scrollbackAggregateLimit))
     , watchingChannel(Channel::getEmpty(), Channel::Type::TwitchWatching)
 {
     this->initializeIrc();
@@ -232,11 +232,11 @@ MessagePtr TwitchMessageBuilder::build()
 
     // timestamp
     this->message().serverReceivedTime = calculateMessageTime(this->ircMessage);
-    this->emplace<TimestampElement>(this->message().serverReceivedTime.time());
+    this->appendTimestamp(this->message().serverReceivedTime.time());
 
     if (this->shouldAddModerationElements())
     {
-        this->emplace<TwitchModerationElement>();
+        this->append(TwitchModerationElement::instance());
     }
 
     this->appendTwitchBadges();
@@ -260,8 +260,19 @@ MessagePtr TwitchMessageBuilder::build()
     auto twitchEmotes = TwitchMessageBuilder::parseTwitchEmotes(
         this->tags, this->originalMessage_, this->messageOffset_);
 
-    // This runs through all ignored phrases and runs its replacements on this->originalMessage_
-    this->runIgnoreReplaces(twitchEmotes);
+    if (!this->rebuildingElements_)
+    {
+        const auto unreplaced = this->originalMessage_;
+
+        // This runs through all ignored phrases and runs its replacements on this->originalMessage_
+        this->runIgnoreReplaces(twitchEmotes);
+
+        if (this->originalMessage_ != unreplaced)
+        {
+            // Rebuilding would apply today's phrases, so don't compact it
+            this->message().ircData.clear();
+        }
+    }
 
     std::sort(twitchEmotes.begin(), twitchEmotes.end(),
               [](const auto &a, const auto &b) {
@@ -283,7 +294,10 @@ MessagePtr TwitchMessageBuilder::build()
                                  this->userName + ": " + this->originalMessage_;
 
     // highlights
-    this->parseHighlights();
+    if (!this->rebuildingElements_)
+    {
+        this->parseHighlights();
+    }
 
     // highlighting incoming whispers if requested per setting
     if (this->args.isReceivedWhisper && getSettings()->highlightInlineWhispers)
@@ -576,8 +590,11 @@ void TwitchMessageBuilder::parseThread()
     if (this->thread_)
     {
         // set references
-        this->message().replyThread = this->thread_;
-        this->thread_->addToThread(this->weakOf());
+        if (!this->rebuildingElements_)
+        {
+            this->message().replyThread = this->thread_;
+            this->thread_->addToThread(this->weakOf());
+        }
 
         // enable reply flag
         this->message().flags.set(MessageFlag::ReplyMessage);
@@ -691,6 +708,11 @@ void TwitchMessageBuilder::parseUsername()
     //    }
 
     this->message().loginName = this->userName;
+    if (this->rebuildingElements_)
+    {
+        return;
+    }
+
     if (this->twitchChannel != nullptr)
     {
         this->twitchChannel->setUserColor(this->userName, this->usernameColor_);
@@ -1163,10 +1185,10 @@ void TwitchMessageBuilder::appendTwitchBadges()
         {
             if (auto customModBadge = this->twitchChannel->ffzCustomModBadge())
             {
-                this->emplace<ModBadgeElement>(
-                        customModBadge.get(),
-                        MessageElementFlag::BadgeChannelAuthority)
-                    ->setTooltip((*customModBadge)->tooltip.string);
+                this->append(BadgeElement::interned<ModBadgeElement>(
+                    customModBadge.get(),
+                    MessageElementFlag::BadgeChannelAuthority,
+                    (*customModBadge)->tooltip.string));
                 // early out, since we have to add a custom badge element here
                 continue;
             }
@@ -1175,10 +1197,10 @@ void TwitchMessageBuilder::appendTwitchBadges()
         {
             if (auto customVipBadge = this->twitchChannel->ffzCustomVipBadge())
             {
-                this->emplace<VipBadgeElement>(
-                        customVipBadge.get(),
-                        MessageElementFlag::BadgeChannelAuthority)
-                    ->setTooltip((*customVipBadge)->tooltip.string);
+                this->append(BadgeElement::interned<VipBadgeElement>(
+                    customVipBadge.get(),
+                    MessageElementFlag::BadgeChannelAuthority,
+                    (*customVipBadge)->tooltip.string));
                 // early out, since we have to add a custom badge element here
                 continue;
             }
@@ -1218,8 +1240,8 @@ void TwitchMessageBuilder::appendTwitchBadges()
             }
         }
 
-        this->emplace<BadgeElement>(badgeEmote.get(), badge.flag_)
-            ->setTooltip(tooltip);
+        this->append(BadgeElement::interned<BadgeElement>(
+            badgeEmote.get(), badge.flag_, tooltip));
     }
 
     this->message().badges = badges;
@@ -1230,8 +1252,9 @@ void TwitchMessageBuilder::appendChatterinoBadges()
 {
     if (auto badge = getApp()->chatterinoBadges->getBadge({this->userId_}))
     {
-        this->emplace<BadgeElement>(*badge,
-                                    MessageElementFlag::BadgeChatterino);
+        this->append(BadgeElement::interned<BadgeElement>(
+            *badge, MessageElementFlag::BadgeChatterino,
+            (*badge)->tooltip.string));
     }
 }
 
@@ -1249,7 +1272,9 @@ void TwitchMessageBuilder::appendSeventvBadges()
 {
     if (auto badge = getApp()->seventvBadges->getBadge({this->userId_}))
     {
-        this->emplace<BadgeElement>(*badge, MessageElementFlag::BadgeSevenTV);
+        this->append(BadgeElement::interned<BadgeElement>(
+            *badge, MessageElementFlag::BadgeSevenTV,
+            (*badge)->tooltip.string));
     }
 }
 
@@ -1372,7 +1397,7 @@ void TwitchMessageBuilder::appendChannelPointRewardMessage(
         return;
     }
 
-    builder->emplace<TimestampElement>();
+    builder->appendTimestamp();
     QString redeemed = "Redeemed";
     QStringList textList;
     if (!reward.isUserInputRequired)
@@ -1411,7 +1436,7 @@ void TwitchMessageBuilder::appendChannelPointRewardMessage(
 void TwitchMessageBuilder::liveMessage(const QString &channelName,
                                        MessageBuilder *builder)
 {
-    builder->emplace<TimestampElement>();
+    builder->appendTimestamp();
     builder
         ->emplace<TextElement>(channelName, MessageElementFlag::Username,
                                MessageColor::Text, FontStyle::ChatMediumBold)
@@ -1426,7 +1451,7 @@ void TwitchMessageBuilder::liveMessage(const QString &channelName,
 void TwitchMessageBuilder::liveSystemMessage(const QString &channelName,
                                              MessageBuilder *builder)
 {
-    builder->emplace<TimestampElement>();
+    builder->appendTimestamp();
     builder->message().flags.set(MessageFlag::System);
     builder->message().flags.set(MessageFlag::DoNotTriggerNotification);
     builder
@@ -1443,7 +1468,7 @@ void TwitchMessageBuilder::liveSystemMessage(const QString &channelName,
 void TwitchMessageBuilder::offlineSystemMessage(const QString &channelName,
                                                 MessageBuilder *builder)
 {
-    builder->emplace<TimestampElement>();
+    builder->appendTimestamp();
     builder->message().flags.set(MessageFlag::System);
     builder->message().flags.set(MessageFlag::DoNotTriggerNotification);
     builder
@@ -1462,7 +1487,7 @@ void TwitchMessageBuilder::hostingSystemMessage(const QString &channelName,
                                                 bool hostOn)
 {
     QString text;
-    builder->emplace<TimestampElement>();
+    builder->appendTimestamp();
     builder->message().flags.set(MessageFlag::System);
     builder->message().flags.set(MessageFlag::DoNotTriggerNotification);
     if (hostOn)
@@ -1497,7 +1522,7 @@ void TwitchMessageBuilder::hostingSystemMessage(const QString &channelName,
 void TwitchMessageBuilder::deletionMessage(const MessagePtr originalMessage,
                                            MessageBuilder *builder)
 {
-    builder->emplace<TimestampElement>();
+    builder->appendTimestamp();
     builder->message().flags.set(MessageFlag::System);
     builder->message().flags.set(MessageFlag::DoNotTriggerNotification);
     builder->message().flags.set(MessageFlag::Timeout);
@@ -1533,7 +1558,7 @@ void TwitchMessageBuilder::deletionMessage(const MessagePtr originalMessage,
 void TwitchMessageBuilder::deletionMessage(const DeleteAction &action,
                                            MessageBuilder *builder)
 {
-    builder->emplace<TimestampElement>();
+    builder->appendTimestamp();
     builder->message().flags.set(MessageFlag::System);
     builder->message().flags.set(MessageFlag::DoNotTriggerNotification);
     builder->message().flags.set(MessageFlag::Timeout);
@@ -1581,7 +1606,7 @@ void TwitchMessageBuilder::listOfUsersSystemMessage(QString prefix,
     builder->message().messageText = text;
     builder->message().searchText = text;
 
-    builder->emplace<TimestampElement>();
+    builder->appendTimestamp();
     builder->message().flags.set(MessageFlag::System);
     builder->message().flags.set(MessageFlag::DoNotTriggerNotification);
     builder->emplace<TextElement>(prefix, MessageElementFlag::Text,
@@ -1628,7 +1653,7 @@ void TwitchMessageBuilder::listOfUsersSystemMessage(
 {
     QString text = prefix;
 
-    builder->emplace<TimestampElement>();
+    builder->appendTimestamp();
     builder->message().flags.set(MessageFlag::System);
     builder->message().flags.set(MessageFlag::DoNotTriggerNotification);
     builder->emplace<TextElement>(prefix, MessageElementFlag::Text,
@@ -1688,4 +1713,9 @@ void TwitchMessageBuilder::setMessageOffset(int offset)
     this->messageOffset_ = offset;
 }
 
+void TwitchMessageBuilder::setRebuildingElements()
+{
+    this->rebuildingElements_ = true;
+}
+
 }  // namespace chatterino
@@ -55,6 +55,10 @@ public:
 
     void setThread(std::shared_ptr<MessageThread> thread);
     void setMessageOffset(int offset);
+    // Only builds the elements of a compacted message again. The thread,
+    // chatter colors and highlights are left alone and ignored phrases
+    // aren't applied, the message being rebuilt keeps its own outcome.
+    void setRebuildingElements();
 
     static void appendChannelPointRewardMessage(
         const ChannelPointReward &reward, MessageBuilder *builder, bool isMod,
@@ -124,6 +128,7 @@ private:
     int bitsLeft;
     bool bitsStacked = false;
     bool historicalMessage_ = false;
+    bool rebuildingElements_ = false;
     std::shared_ptr<MessageThread> thread_;
 
     /**
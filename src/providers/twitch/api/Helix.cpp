@@ -1792,33 +1792,40 @@ void Helix::updateChatSettings(
         .execute();
 }
 
-void Helix::onFetchChattersSuccess(
-    std::shared_ptr<HelixChatters> finalChatters, QString broadcasterID,
-    QString moderatorID, int maxChattersToFetch,
-    ResultCallback<HelixChatters> successCallback,
+void Helix::onFetchChattersPage(
+    int fetchedChatters, QString broadcasterID, QString moderatorID,
+    int maxChattersToFetch,
+    std::function<bool(const HelixChatters &)> pageCallback,
+    ResultCallback<bool> finishedCallback,
     FailureCallback<HelixGetChattersError, QString> failureCallback,
     HelixChatters chatters)
 {
     qCDebug(chatterinoTwitch)
         << "Fetched" << chatters.chatters.size() << "chatters";
 
-    finalChatters->chatters.merge(chatters.chatters);
-    finalChatters->total = chatters.total;
+    fetchedChatters += static_cast<int>(chatters.chatters.size());
 
-    if (chatters.cursor.isEmpty() ||
-        finalChatters->chatters.size() >= maxChattersToFetch)
+    if (!pageCallback(chatters))
+    {
+        // Cancelled by the caller
+        finishedCallback(false);
+        return;
+    }
+
+    if (chatters.cursor.isEmpty() || fetchedChatters >= maxChattersToFetch)
     {
         // Done paginating
-        successCallback(*finalChatters);
+        finishedCallback(true);
         return;
     }
 
     this->fetchChatters(
         broadcasterID, moderatorID, NUM_CHATTERS_TO_FETCH, chatters.cursor,
         [=, this](auto chatters) {
-            this->onFetchChattersSuccess(
-                finalChatters, broadcasterID, moderatorID, maxChattersToFetch,
-                successCallback, failureCallback, chatters);
+            this->onFetchChattersPage(fetchedChatters, broadcasterID,
+                                      moderatorID, maxChattersToFetch,
+                                      pageCallback, finishedCallback,
+                                      failureCallback, chatters);
         },
         failureCallback);
 }
@@ -1843,18 +1850,20 @@ void Helix::fetchChatters(
     }
 
     this->makeRequest("chat/chatters", urlQuery)
-        .onSuccess([successCallback](auto result) -> Outcome {
-            if (result.status() != 200)
-            {
-                qCWarning(chatterinoTwitch)
-                    << "Success result for getting chatters was "
-                    << result.status() << "but we expected it to be 200";
-            }
-
-            auto response = result.parseJson();
-            successCallback(HelixChatters(response));
-            return Success;
-        })
+        .onSuccessDecoded(
+            [](const NetworkResult &result) {
+                if (result.status() != 200)
+                {
+                    qCWarning(chatterinoTwitch)
+                        << "Success result for getting chatters was "
+                        << result.status() << "but we expected it to be 200";
+                }
+
+                return HelixChatters(result.parseJson());
+            },
+            [successCallback](HelixChatters &&chatters) {
+                successCallback(std::move(chatters));
+            })
         .onError([failureCallback](auto result) {
             auto obj = result.parseJson();
             auto message = obj.value("message").toString();
@@ -2233,13 +2242,35 @@ void Helix::getChatters(
 {
     auto finalChatters = std::make_shared<HelixChatters>();
 
+    this->getChattersPaged(
+        broadcasterID, moderatorID, maxChattersToFetch,
+        [finalChatters](const HelixChatters &chatters) {
+            finalChatters->chatters.insert(chatters.chatters.begin(),
+                                           chatters.chatters.end());
+            finalChatters->total = chatters.total;
+            return true;
+        },
+        [finalChatters, successCallback](bool /*complete*/) {
+            successCallback(*finalChatters);
+        },
+        failureCallback);
+}
+
+// https://dev.twitch.tv/docs/api/reference#get-chatters
+void Helix::getChattersPaged(
+    QString broadcasterID, QString moderatorID, int maxChattersToFetch,
+    std::function<bool(const HelixChatters &)> pageCallback,
+    ResultCallback<bool> finishedCallback,
+    FailureCallback<HelixGetChattersError, QString> failureCallback)
+{
     // Initiate the recursive calls
     this->fetchChatters(
         broadcasterID, moderatorID, NUM_CHATTERS_TO_FETCH, "",
         [=, this](auto chatters) {
-            this->onFetchChattersSuccess(
-                finalChatters, broadcasterID, moderatorID, maxChattersToFetch,
-                successCallback, failureCallback, chatters);
+            this->onFetchChattersPage(0, broadcasterID, moderatorID,
+                                      maxChattersToFetch, pageCallback,
+                                      finishedCallback, failureCallback,
+                                      chatters);
         },
         failureCallback);
 }
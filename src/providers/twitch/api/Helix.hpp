@@ -890,6 +890,19 @@ public:
         ResultCallback<HelixChatters> successCallback,
         FailureCallback<HelixGetChattersError, QString> failureCallback) = 0;
 
+    // Get Chatters from the `broadcasterID` channel one page at a time
+    // `pageCallback` is called for every page as soon as it arrives and returns
+    // whether the next page should be fetched.
+    // `finishedCallback` is called with true once all pages up to
+    // `maxChattersToFetch` chatters have arrived, or with false if
+    // `pageCallback` stopped the pagination.
+    // https://dev.twitch.tv/docs/api/reference#get-chatters
+    virtual void getChattersPaged(
+        QString broadcasterID, QString moderatorID, int maxChattersToFetch,
+        std::function<bool(const HelixChatters &)> pageCallback,
+        ResultCallback<bool> finishedCallback,
+        FailureCallback<HelixGetChattersError, QString> failureCallback) = 0;
+
     // Get moderators from the `broadcasterID` channel
     // This will follow the returned cursor
     // https://dev.twitch.tv/docs/api/reference#get-moderators
@@ -1174,6 +1187,14 @@ public:
         ResultCallback<HelixChatters> successCallback,
         FailureCallback<HelixGetChattersError, QString> failureCallback) final;
 
+    // Get Chatters from the `broadcasterID` channel one page at a time
+    // https://dev.twitch.tv/docs/api/reference#get-chatters
+    void getChattersPaged(
+        QString broadcasterID, QString moderatorID, int maxChattersToFetch,
+        std::function<bool(const HelixChatters &)> pageCallback,
+        ResultCallback<bool> finishedCallback,
+        FailureCallback<HelixGetChattersError, QString> failureCallback) final;
+
     // Get moderators from the `broadcasterID` channel
     // This will follow the returned cursor
     // https://dev.twitch.tv/docs/api/reference#get-moderators
@@ -1209,10 +1230,11 @@ protected:
         final;
 
     // Recursive boy
-    void onFetchChattersSuccess(
-        std::shared_ptr<HelixChatters> finalChatters, QString broadcasterID,
-        QString moderatorID, int maxChattersToFetch,
-        ResultCallback<HelixChatters> successCallback,
+    void onFetchChattersPage(
+        int fetchedChatters, QString broadcasterID, QString moderatorID,
+        int maxChattersToFetch,
+        std::function<bool(const HelixChatters &)> pageCallback,
+        ResultCallback<bool> finishedCallback,
         FailureCallback<HelixGetChattersError, QString> failureCallback,
         HelixChatters chatters);
 
@@ -233,6 +233,7 @@ public:
     /// Links
     BoolSetting linksDoubleClickOnly = {"/links/doubleClickToOpen", false};
     BoolSetting linkInfoTooltip = {"/links/linkInfoTooltip", false};
+    BoolSetting linkInfoPrefetch = {"/links/linkInfoPrefetch", true};
     IntSetting thumbnailSize = {"/appearance/thumbnailSize", 0};
     IntSetting thumbnailSizeStream = {"/appearance/thumbnailSizeStream", 2};
     BoolSetting unshortLinks = {"/links/unshortLinks", false};
@@ -442,6 +443,16 @@ public:
         "/misc/scrollback/usercardLimit",
         1000,
     };
+    IntSetting scrollbackAggregateLimit = {
+        "/misc/scrollback/aggregateLimit",
+        500,
+    };
+    // Minutes after which messages far above the viewport drop their
+    // elements until they're shown again. 0 disables compaction.
+    IntSetting messageCompactionAge = {
+        "/misc/scrollback/compactionAge",
+        30,
+    };
 
     // Temporary time-gate-overrides
     EnumSetting<HelixTimegateOverride> helixTimegateRaid = {
@@ -15,9 +15,13 @@
 #include "singletons/Theme.hpp"
 #include "util/Clamp.hpp"
 #include "util/CombinePath.hpp"
+#include "util/DebugCount.hpp"
+#include "util/PostToThread.hpp"
+#include "util/StreamerMode.hpp"
 #include "widgets/AccountSwitchPopup.hpp"
 #include "widgets/dialogs/SettingsDialog.hpp"
 #include "widgets/FramelessEmbedWindow.hpp"
+#include "widgets/helper/ChannelView.hpp"
 #include "widgets/helper/NotebookTab.hpp"
 #include "widgets/Notebook.hpp"
 #include "widgets/splits/Split.hpp"
@@ -25,14 +29,17 @@
 #include "widgets/Window.hpp"
 
 #include <boost/optional.hpp>
+#include <QCryptographicHash>
 #include <QDebug>
 #include <QDesktopWidget>
+#include <QElapsedTimer>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QMessageBox>
 #include <QSaveFile>
 #include <QScreen>
+#include <QThreadPool>
 
 #include <chrono>
 
@@ -45,6 +52,76 @@ namespace {
         return x;
     }
 
+    // Logs the time from `timer` until `window` was first painted
+    class FirstPaintLogger : public QObject
+    {
+    public:
+        FirstPaintLogger(QWidget *window, const QElapsedTimer &timer)
+            : QObject(window)
+            , timer_(timer)
+        {
+            window->installEventFilter(this);
+        }
+
+        bool eventFilter(QObject *watched, QEvent *event) override
+        {
+            if (event->type() == QEvent::Paint)
+            {
+                qCDebug(chatterinoWindowmanager)
+                    << "Time to first paint:" << this->timer_.elapsed()
+                    << "ms";
+                watched->removeEventFilter(this);
+                this->deleteLater();
+            }
+
+            return false;
+        }
+
+    private:
+        QElapsedTimer timer_;
+    };
+
+    // Writes `layout` to `path` unless the last written file had the same
+    // contents. The file is only replaced once it was written completely.
+    bool writeLayout(const QString &path, const WindowLayout &layout,
+                     QByteArray &writtenHash)
+    {
+        QElapsedTimer timer;
+        timer.start();
+
+        QJsonDocument::JsonFormat format =
+#ifdef _DEBUG
+            QJsonDocument::JsonFormat::Compact
+#else
+            (QJsonDocument::JsonFormat)0
+#endif
+            ;
+
+        auto data = layout.toJSON().toJson(format);
+        auto hash = QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+        if (hash == writtenHash)
+        {
+            DebugCount::increase("window layout writes skipped");
+            return true;
+        }
+
+        QSaveFile file(path);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) ||
+            file.write(data) == -1 || !file.commit())
+        {
+            qCWarning(chatterinoWindowmanager)
+                << "Failed to write window layout to" << path
+                << file.errorString();
+            return false;
+        }
+
+        writtenHash = hash;
+        DebugCount::increase("window layout writes");
+        DebugCount::increase("window layout write time (us)",
+                             timer.nsecsElapsed() / 1000);
+        return true;
+    }
+
 }  // namespace
 
 const QString WindowManager::WINDOW_LAYOUT_FILENAME(
@@ -97,7 +174,10 @@ void WindowManager::showAccountSelectPopup(QPoint point)
 WindowManager::WindowManager()
     : windowLayoutFilePath(combinePath(getPaths()->settingsDirectory,
                                        WindowManager::WINDOW_LAYOUT_FILENAME))
+    , saveState_(std::make_shared<SaveState>())
 {
+    this->startupTimer_.start();
+
     qCDebug(chatterinoWindowmanager) << "init WindowManager";
 
     auto settings = getSettings();
@@ -123,8 +203,8 @@ WindowManager::WindowManager()
 
     this->saveTimer->setSingleShot(true);
 
-    QObject::connect(this->saveTimer, &QTimer::timeout, [] {
-        getApp()->windows->save();
+    QObject::connect(this->saveTimer, &QTimer::timeout, [this] {
+        this->saveAsync();
     });
 
     this->miscUpdateTimer_.start(100);
@@ -211,7 +291,7 @@ void WindowManager::updateWordTypeMask()
 
 void WindowManager::layoutChannelViews(Channel *channel)
 {
-    this->layoutRequested.invoke(channel);
+    ChannelView::requestLayout(channel);
 }
 
 void WindowManager::forceLayoutChannelViews()
@@ -222,7 +302,7 @@ void WindowManager::forceLayoutChannelViews()
 
 void WindowManager::repaintVisibleChatWidgets(Channel *channel)
 {
-    this->layoutRequested.invoke(channel);
+    ChannelView::requestLayout(channel);
 }
 
 void WindowManager::repaintGifEmotes()
@@ -413,6 +493,12 @@ void WindowManager::initialize(Settings &settings, Paths &paths)
         this->forceLayoutChannelViews();
     });
 
+    // Messages hide their moderation buttons in streamer mode
+    initStreamerMode();
+    streamerModeChanged().connect([this] {
+        this->forceLayoutChannelViews();
+    });
+
     this->initialized_ = true;
 }
 
@@ -424,88 +510,89 @@ void WindowManager::save()
     }
     qCDebug(chatterinoWindowmanager) << "[WindowManager] Saving";
     assertInGuiThread();
-    QJsonDocument document;
 
-    // "serialize"
-    QJsonArray windowArr;
-    for (Window *window : this->windows_)
+    this->saveTimer->stop();
+
+    auto layout = this->captureLayout();
+    auto generation = ++this->saveGeneration_;
+
+    // Waits for a write that's still in progress
+    std::lock_guard lock(this->saveState_->mutex);
+    if (writeLayout(this->windowLayoutFilePath, layout,
+                    this->saveState_->writtenHash))
     {
-        QJsonObject windowObj;
+        this->saveState_->writtenGeneration = generation;
+    }
+}
 
-        // window type
-        switch (window->getType())
-        {
-            case WindowType::Main:
-                windowObj.insert("type", "main");
-                break;
+void WindowManager::saveAsync()
+{
+    if (getArgs().dontSaveSettings)
+    {
+        return;
+    }
+    assertInGuiThread();
 
-            case WindowType::Popup:
-                windowObj.insert("type", "popup");
-                break;
+    auto generation = ++this->saveGeneration_;
 
-            case WindowType::Attached:;
-        }
+    QThreadPool::globalInstance()->start(new LambdaRunnable(
+        [state = this->saveState_, path = this->windowLayoutFilePath,
+         generation, layout = this->captureLayout()] {
+            std::lock_guard lock(state->mutex);
+            if (state->writtenGeneration >= generation)
+            {
+                // A newer layout was written in the meantime
+                return;
+            }
+
+            if (writeLayout(path, layout, state->writtenHash))
+            {
+                state->writtenGeneration = generation;
+            }
+        }));
+}
+
+WindowLayout WindowManager::captureLayout() const
+{
+    assertInGuiThread();
+
+    WindowLayout layout;
+    layout.emotePopupPos_ = this->emotePopupPos_;
+    layout.windows_.reserve(this->windows_.size());
+
+    for (Window *window : this->windows_)
+    {
+        WindowDescriptor descriptor;
+        descriptor.type_ = window->getType();
 
         if (window->isMaximized())
         {
-            windowObj.insert("state", "maximized");
+            descriptor.state_ = WindowDescriptor::State::Maximized;
         }
         else if (window->isMinimized())
         {
-            windowObj.insert("state", "minimized");
+            descriptor.state_ = WindowDescriptor::State::Minimized;
         }
 
-        // window geometry
-        auto rect = window->getBounds();
-
-        windowObj.insert("x", rect.x());
-        windowObj.insert("y", rect.y());
-        windowObj.insert("width", rect.width());
-        windowObj.insert("height", rect.height());
-
-        QJsonObject emotePopupObj;
-        emotePopupObj.insert("x", this->emotePopupPos_.x());
-        emotePopupObj.insert("y", this->emotePopupPos_.y());
-        windowObj.insert("emotePopup", emotePopupObj);
-
-        // window tabs
-        QJsonArray tabsArr;
+        descriptor.geometry_ = window->getBounds();
 
-        for (int tabIndex = 0; tabIndex < window->getNotebook().getPageCount();
-             tabIndex++)
+        auto &notebook = window->getNotebook();
+        descriptor.tabs_.reserve(notebook.getPageCount());
+        for (int tabIndex = 0; tabIndex < notebook.getPageCount(); tabIndex++)
         {
-            QJsonObject tabObj;
-            SplitContainer *tab = dynamic_cast<SplitContainer *>(
-                window->getNotebook().getPageAt(tabIndex));
+            SplitContainer *tab =
+                dynamic_cast<SplitContainer *>(notebook.getPageAt(tabIndex));
             assert(tab != nullptr);
 
-            bool isSelected = window->getNotebook().getSelectedPage() == tab;
-            WindowManager::encodeTab(tab, isSelected, tabObj);
-            tabsArr.append(tabObj);
+            bool isSelected = notebook.getSelectedPage() == tab;
+            descriptor.tabs_.push_back(
+                WindowManager::describeTab(tab, isSelected));
         }
 
-        windowObj.insert("tabs", tabsArr);
-        windowArr.append(windowObj);
+        layout.windows_.push_back(std::move(descriptor));
     }
 
-    QJsonObject obj;
-    obj.insert("windows", windowArr);
-    document.setObject(obj);
-
-    // save file
-    QSaveFile file(this->windowLayoutFilePath);
-    file.open(QIODevice::WriteOnly | QIODevice::Truncate);
-
-    QJsonDocument::JsonFormat format =
-#ifdef _DEBUG
-        QJsonDocument::JsonFormat::Compact
-#else
-        (QJsonDocument::JsonFormat)0
-#endif
-        ;
-
-    file.write(document.toJson(format));
-    file.commit();
+    return layout;
 }
 
 void WindowManager::sendAlert()
@@ -525,125 +612,112 @@ void WindowManager::queueSave()
     this->saveTimer->start(10s);
 }
 
-void WindowManager::encodeTab(SplitContainer *tab, bool isSelected,
-                              QJsonObject &obj)
+TabDescriptor WindowManager::describeTab(SplitContainer *tab,
+                                         bool isSelected)
 {
+    TabDescriptor descriptor;
+
     // custom tab title
     if (tab->getTab()->hasCustomTitle())
     {
-        obj.insert("title", tab->getTab()->getCustomTitle());
+        descriptor.customTitle_ = tab->getTab()->getCustomTitle();
     }
 
-    // selected
-    if (isSelected)
-    {
-        obj.insert("selected", true);
-    }
+    descriptor.selected_ = isSelected;
 
     // highlighting on new messages
-    obj.insert("highlightsEnabled", tab->getTab()->hasHighlightsEnabled());
+    descriptor.highlightsEnabled_ = tab->getTab()->hasHighlightsEnabled();
 
     // splits
-    QJsonObject splits;
-
-    WindowManager::encodeNodeRecursively(tab->getBaseNode(), splits);
+    if (tab->getPendingDescriptor())
+    {
+        descriptor.rootNode_ = tab->getPendingDescriptor();
+    }
+    else if (tab->getBaseNode()->getType() != SplitNode::Type::EmptyRoot)
+    {
+        descriptor.rootNode_ =
+            WindowManager::describeNodeRecursively(tab->getBaseNode());
+    }
 
-    obj.insert("splits2", splits);
+    return descriptor;
 }
 
-void WindowManager::encodeNodeRecursively(SplitNode *node, QJsonObject &obj)
+NodeDescriptor WindowManager::describeNodeRecursively(SplitNode *node)
 {
-    switch (node->getType())
+    if (node->getType() == SplitNode::Type::Split)
     {
-        case SplitNode::Type::Split: {
-            obj.insert("type", "split");
-            obj.insert("moderationMode", node->getSplit()->getModerationMode());
+        SplitNodeDescriptor descriptor;
+        static_cast<SplitDescriptor &>(descriptor) =
+            WindowManager::describeSplit(node->getSplit());
+        descriptor.flexH_ = node->getHorizontalFlex();
+        descriptor.flexV_ = node->getVerticalFlex();
+        return descriptor;
+    }
 
-            QJsonObject split;
-            WindowManager::encodeChannel(node->getSplit()->getIndirectChannel(),
-                                         split);
-            obj.insert("data", split);
+    ContainerNodeDescriptor descriptor;
+    descriptor.vertical_ =
+        node->getType() == SplitNode::Type::VerticalContainer;
+    descriptor.flexH_ = node->getHorizontalFlex();
+    descriptor.flexV_ = node->getVerticalFlex();
 
-            QJsonArray filters;
-            WindowManager::encodeFilters(node->getSplit(), filters);
-            obj.insert("filters", filters);
-        }
-        break;
-        case SplitNode::Type::HorizontalContainer:
-        case SplitNode::Type::VerticalContainer: {
-            obj.insert("type",
-                       node->getType() == SplitNode::Type::HorizontalContainer
-                           ? "horizontal"
-                           : "vertical");
-
-            QJsonArray itemsArr;
-            for (const std::unique_ptr<SplitNode> &n : node->getChildren())
-            {
-                QJsonObject subObj;
-                WindowManager::encodeNodeRecursively(n.get(), subObj);
-                itemsArr.append(subObj);
-            }
-            obj.insert("items", itemsArr);
-        }
-        break;
+    descriptor.items_.reserve(node->getChildren().size());
+    for (const std::unique_ptr<SplitNode> &n : node->getChildren())
+    {
+        descriptor.items_.push_back(
+            WindowManager::describeNodeRecursively(n.get()));
     }
 
-    obj.insert("flexh", node->getHorizontalFlex());
-    obj.insert("flexv", node->getVerticalFlex());
+    return descriptor;
 }
 
-void WindowManager::encodeChannel(IndirectChannel channel, QJsonObject &obj)
+SplitDescriptor WindowManager::describeSplit(Split *split)
 {
     assertInGuiThread();
 
+    SplitDescriptor descriptor;
+    descriptor.moderationMode_ = split->getModerationMode();
+    descriptor.filters_ = split->getFilters();
+
+    auto channel = split->getIndirectChannel();
     switch (channel.getType())
     {
         case Channel::Type::Twitch: {
-            obj.insert("type", "twitch");
-            obj.insert("name", channel.get()->getName());
+            descriptor.type_ = "twitch";
+            descriptor.channelName_ = channel.get()->getName();
         }
         break;
         case Channel::Type::TwitchMentions: {
-            obj.insert("type", "mentions");
+            descriptor.type_ = "mentions";
         }
         break;
         case Channel::Type::TwitchWatching: {
-            obj.insert("type", "watching");
+            descriptor.type_ = "watching";
         }
         break;
         case Channel::Type::TwitchWhispers: {
-            obj.insert("type", "whispers");
+            descriptor.type_ = "whispers";
         }
         break;
         case Channel::Type::TwitchLive: {
-            obj.insert("type", "live");
+            descriptor.type_ = "live";
         }
         break;
         case Channel::Type::Irc: {
             if (auto ircChannel =
                     dynamic_cast<IrcChannel *>(channel.get().get()))
             {
-                obj.insert("type", "irc");
+                descriptor.type_ = "irc";
                 if (ircChannel->server())
                 {
-                    obj.insert("server", ircChannel->server()->id());
+                    descriptor.server_ = ircChannel->server()->id();
                 }
-                obj.insert("channel", ircChannel->getName());
+                descriptor.channelName_ = ircChannel->getName();
             }
         }
         break;
     }
-}
-
-void WindowManager::encodeFilters(Split *split, QJsonArray &arr)
-{
-    assertInGuiThread();
 
-    auto filters = split->getFilters();
-    for (const auto &f : filters)
-    {
-        arr.append(f.toString(QUuid::WithoutBraces));
-    }
+    return descriptor;
 }
 
 IndirectChannel WindowManager::decodeChannel(const SplitDescriptor &descriptor)
@@ -790,11 +864,18 @@ void WindowManager::applyWindowLayout(const WindowLayout &layout)
             // highlighting on new messages
             page->getTab()->setHighlightsEnabled(tab.highlightsEnabled_);
 
+            // splits are created once the tab is shown
             if (tab.rootNode_)
             {
-                page->applyFromDescriptor(*tab.rootNode_);
+                page->setPendingDescriptor(*tab.rootNode_);
             }
         }
+
+        if (type == WindowType::Main)
+        {
+            new FirstPaintLogger(&window, this->startupTimer_);
+        }
+
         window.show();
 
         // Set window state
@@ -7,7 +7,10 @@
 #include "pajlada/settings/settinglistener.hpp"
 #include "widgets/splits/SplitContainer.hpp"
 
+#include <QElapsedTimer>
+
 #include <memory>
+#include <mutex>
 
 namespace chatterino {
 
@@ -32,10 +35,8 @@ public:
     WindowManager();
     ~WindowManager() override;
 
-    static void encodeTab(SplitContainer *tab, bool isSelected,
-                          QJsonObject &obj);
-    static void encodeChannel(IndirectChannel channel, QJsonObject &obj);
-    static void encodeFilters(Split *split, QJsonArray &arr);
+    static TabDescriptor describeTab(SplitContainer *tab, bool isSelected);
+    static SplitDescriptor describeSplit(Split *split);
     static IndirectChannel decodeChannel(const SplitDescriptor &descriptor);
 
     void showSettingsDialog(
@@ -101,10 +102,6 @@ public:
     /// Signals
     pajlada::Signals::NoArgSignal gifRepaintRequested;
 
-    // This signal fires whenever views rendering a channel, or all views if the
-    // channel is a nullptr, need to redo their layout
-    pajlada::Signals::Signal<Channel *> layoutRequested;
-
     pajlada::Signals::NoArgSignal wordFlagsChanged;
 
     // This signal fires every 100ms and can be used to trigger random things that require a recheck.
@@ -116,8 +113,14 @@ public:
     pajlada::Signals::Signal<const MessagePtr &> scrollToMessageSignal;
 
 private:
-    static void encodeNodeRecursively(SplitContainer::Node *node,
-                                      QJsonObject &obj);
+    static NodeDescriptor describeNodeRecursively(SplitContainer::Node *node);
+
+    // Captures the current layout of all windows. The result doesn't refer to
+    // any widgets, so it can be serialized on another thread.
+    WindowLayout captureLayout() const;
+
+    // Serializes and writes the current layout on a worker thread
+    void saveAsync();
 
     // Load window layout from the window-layout.json file
     WindowLayout loadWindowLayoutFromFile() const;
@@ -143,7 +146,20 @@ private:
     MessageElementFlags wordFlags_{};
     pajlada::SettingListener wordFlagsListener_;
 
+    struct SaveState {
+        // Held while the layout file is being written
+        std::mutex mutex;
+        // Hash of the contents of the last layout file that was written
+        QByteArray writtenHash;
+        uint64_t writtenGeneration = 0;
+    };
+
+    // Started when the window manager is created, for startup timings
+    QElapsedTimer startupTimer_;
+
     QTimer *saveTimer;
+    uint64_t saveGeneration_ = 0;
+    std::shared_ptr<SaveState> saveState_;
     QTimer miscUpdateTimer_;
 };
 
@@ -2,16 +2,20 @@
 
 #include "Application.hpp"
 #include "common/QLogging.hpp"
+#include "debug/AssertInGuiThread.hpp"
 #include "messages/MessageBuilder.hpp"
 #include "providers/twitch/TwitchIrcServer.hpp"
 #include "singletons/Settings.hpp"
-#include "singletons/WindowManager.hpp"
-#include "widgets/helper/NotebookTab.hpp"
-#include "widgets/Notebook.hpp"
-#include "widgets/splits/Split.hpp"
-#include "widgets/Window.hpp"
+#include "util/PostToThread.hpp"
 
+#include <QDir>
+#include <QFile>
 #include <QProcess>
+#include <QThreadPool>
+#include <QTimer>
+
+#include <atomic>
+#include <cassert>
 
 #ifdef USEWINSDK
 // clang-format off
@@ -25,118 +29,226 @@
 
 namespace chatterino {
 
-constexpr int cooldownInS = 10;
-
-bool shouldShowWarning = true;
-
-const QStringList &broadcastingBinaries()
-{
-#ifdef USEWINSDK
-    static QStringList bins = {
-        "obs.exe",         "obs64.exe",        "PRISMLiveStudio.exe",
-        "XSplit.Core.exe", "TwitchStudio.exe", "vMix64.exe"};
-#else
-    static QStringList bins = {"obs", "Twitch Studio", "Streamlabs Desktop"};
-#endif
-    return bins;
-}
+namespace {
 
-bool isInStreamerMode()
-{
-    switch (getSettings()->enableStreamerMode.getEnum())
-    {
-        case StreamerModeSetting::Enabled:
-            return true;
-        case StreamerModeSetting::Disabled:
-            return false;
-        case StreamerModeSetting::DetectStreamingSoftware:
+    constexpr int cooldownInS = 10;
 
-#if defined(Q_OS_LINUX) || defined(Q_OS_MACOS)
+    // Result of the last detection, only used on the GUI thread
+    bool detectedStreamingSoftware = false;
+    // The value returned by isInStreamerMode
+    std::atomic<bool> streamerMode{false};
+    std::atomic<bool> detectionRunning{false};
 
-            static bool cache = false;
-            static QDateTime time = QDateTime();
+    QTimer *detectionTimer = nullptr;
 
-            if (time.isValid() &&
-                time.addSecs(cooldownInS) > QDateTime::currentDateTime())
+#if defined(Q_OS_LINUX)
+    // Compares the names of all running processes, like pgrep -x does.
+    // Process names in /proc/<pid>/comm are cut off after 15 characters.
+    bool detectStreamingSoftware()
+    {
+        QStringList names;
+        for (const auto &bin : broadcastingBinaries())
+        {
+            names.append(bin.left(15));
+        }
+
+        QDir proc("/proc");
+        const auto pids = proc.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+        for (const auto &pid : pids)
+        {
+            if (pid.isEmpty() || !pid.front().isDigit())
             {
-                return cache;
+                continue;
             }
-            time = QDateTime::currentDateTime();
 
-            QProcess p;
-            p.start("pgrep", {"-x", broadcastingBinaries().join("|")},
-                    QIODevice::NotOpen);
+            QFile comm(proc.filePath(pid + "/comm"));
+            if (!comm.open(QIODevice::ReadOnly))
+            {
+                // The process might have exited in the meantime
+                continue;
+            }
 
-            if (p.waitForFinished(1000) &&
-                p.exitStatus() == QProcess::NormalExit)
+            if (names.contains(QString::fromUtf8(comm.readAll()).trimmed()))
             {
-                cache = (p.exitCode() == 0);
-                return (p.exitCode() == 0);
+                return true;
             }
+        }
 
-            // Fallback to false and showing a warning
+        return false;
+    }
+#elif defined(Q_OS_MACOS)
+    bool shouldShowWarning = true;
 
-            if (shouldShowWarning)
-            {
-                shouldShowWarning = false;
+    void showPgrepWarning()
+    {
+        if (!shouldShowWarning)
+        {
+            return;
+        }
+        shouldShowWarning = false;
+
+        getApp()->twitch->addGlobalSystemMessage(
+            "Streamer Mode is set to Automatic, but pgrep is missing. "
+            "Install it to fix the issue or set Streamer Mode to "
+            "Enabled or Disabled in the Settings.");
+    }
 
-                getApp()->twitch->addGlobalSystemMessage(
-                    "Streamer Mode is set to Automatic, but pgrep is missing. "
-                    "Install it to fix the issue or set Streamer Mode to "
-                    "Enabled or Disabled in the Settings.");
-            }
+    bool detectStreamingSoftware()
+    {
+        QProcess p;
+        p.start("pgrep", {"-x", broadcastingBinaries().join("|")},
+                QIODevice::NotOpen);
 
-            qCWarning(chatterinoStreamerMode) << "pgrep execution timed out!";
+        if (p.waitForFinished(1000) && p.exitStatus() == QProcess::NormalExit)
+        {
+            return p.exitCode() == 0;
+        }
 
-            cache = false;
-            return false;
-#endif
+        // Fallback to false and showing a warning
+        postToThread([] {
+            showPgrepWarning();
+        });
 
-#ifdef USEWINSDK
-            if (!IsWindowsVistaOrGreater())
-            {
-                return false;
-            }
-            static bool cache = false;
-            static QDateTime time = QDateTime();
+        qCWarning(chatterinoStreamerMode) << "pgrep execution timed out!";
 
-            if (time.isValid() &&
-                time.addSecs(cooldownInS) > QDateTime::currentDateTime())
-            {
-                return cache;
-            }
-            time = QDateTime::currentDateTime();
+        return false;
+    }
+#elif defined(USEWINSDK)
+    bool detectStreamingSoftware()
+    {
+        if (!IsWindowsVistaOrGreater())
+        {
+            return false;
+        }
 
-            WTS_PROCESS_INFO *pWPIs = nullptr;
-            DWORD dwProcCount = 0;
+        WTS_PROCESS_INFO *pWPIs = nullptr;
+        DWORD dwProcCount = 0;
+        bool found = false;
 
-            if (WTSEnumerateProcesses(WTS_CURRENT_SERVER_HANDLE, NULL, 1,
-                                      &pWPIs, &dwProcCount))
+        if (WTSEnumerateProcesses(WTS_CURRENT_SERVER_HANDLE, NULL, 1, &pWPIs,
+                                  &dwProcCount))
+        {
+            //Go through all processes retrieved
+            for (DWORD i = 0; i < dwProcCount; i++)
             {
-                //Go through all processes retrieved
-                for (DWORD i = 0; i < dwProcCount; i++)
+                QString processName = QString::fromUtf16(
+                    reinterpret_cast<char16_t *>(pWPIs[i].pProcessName));
+
+                if (broadcastingBinaries().contains(processName))
                 {
-                    QString processName = QString::fromUtf16(
-                        reinterpret_cast<char16_t *>(pWPIs[i].pProcessName));
-
-                    if (broadcastingBinaries().contains(processName))
-                    {
-                        cache = true;
-                        return true;
-                    }
+                    found = true;
+                    break;
                 }
             }
+        }
 
-            if (pWPIs)
-            {
-                WTSFreeMemory(pWPIs);
-            }
+        if (pWPIs)
+        {
+            WTSFreeMemory(pWPIs);
+        }
 
-            cache = false;
+        return found;
+    }
+#else
+    bool detectStreamingSoftware()
+    {
+        return false;
+    }
 #endif
-            return false;
+
+    void updateStreamerMode()
+    {
+        assertInGuiThread();
+
+        bool value = false;
+        switch (getSettings()->enableStreamerMode.getEnum())
+        {
+            case StreamerModeSetting::Enabled:
+                value = true;
+                break;
+            case StreamerModeSetting::Disabled:
+                value = false;
+                break;
+            case StreamerModeSetting::DetectStreamingSoftware:
+                value = detectedStreamingSoftware;
+                break;
+        }
+
+        if (streamerMode.exchange(value) != value)
+        {
+            streamerModeChanged().invoke();
+        }
+    }
+
+    void runDetection()
+    {
+        if (detectionRunning.exchange(true))
+        {
+            // The previous detection hasn't finished yet
+            return;
+        }
+
+        QThreadPool::globalInstance()->start(new LambdaRunnable([] {
+            bool found = detectStreamingSoftware();
+
+            postToThread([found] {
+                detectionRunning = false;
+                detectedStreamingSoftware = found;
+                updateStreamerMode();
+            });
+        }));
     }
-    return false;
+
+}  // namespace
+
+const QStringList &broadcastingBinaries()
+{
+#ifdef USEWINSDK
+    static QStringList bins = {
+        "obs.exe",         "obs64.exe",        "PRISMLiveStudio.exe",
+        "XSplit.Core.exe", "TwitchStudio.exe", "vMix64.exe"};
+#else
+    static QStringList bins = {"obs", "Twitch Studio", "Streamlabs Desktop"};
+#endif
+    return bins;
+}
+
+bool isInStreamerMode()
+{
+    return streamerMode.load(std::memory_order_relaxed);
+}
+
+pajlada::Signals::NoArgSignal &streamerModeChanged()
+{
+    static pajlada::Signals::NoArgSignal signal;
+    return signal;
+}
+
+void initStreamerMode()
+{
+    assertInGuiThread();
+    assert(detectionTimer == nullptr);
+
+    detectionTimer = new QTimer(qApp);
+    detectionTimer->setInterval(cooldownInS * 1000);
+    QObject::connect(detectionTimer, &QTimer::timeout, [] {
+        runDetection();
+    });
+
+    getSettings()->enableStreamerMode.connect([](auto, auto) {
+        if (getSettings()->enableStreamerMode.getEnum() ==
+            StreamerModeSetting::DetectStreamingSoftware)
+        {
+            runDetection();
+            detectionTimer->start();
+        }
+        else
+        {
+            detectionTimer->stop();
+        }
+
+        updateStreamerMode();
+    });
 }
 
 }  // namespace chatterino
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <pajlada/signals/signal.hpp>
 #include <QStringList>
 
 namespace chatterino {
@@ -11,6 +12,18 @@ enum StreamerModeSetting {
 };
 
 const QStringList &broadcastingBinaries();
+
+/// Returns whether streamer mode is active. This only reads a flag and is
+/// safe to call from any thread, streaming software is detected in the
+/// background (see initStreamerMode).
 bool isInStreamerMode();
 
+/// Invoked on the GUI thread whenever isInStreamerMode() changes
+pajlada::Signals::NoArgSignal &streamerModeChanged();
+
+/// Starts following the streamer mode setting and, while it's set to
+/// DetectStreamingSoftware, periodically looks for streaming software on a
+/// worker thread. Must be called from the GUI thread.
+void initStreamerMode();
+
 }  // namespace chatterino
@@ -1,9 +1,11 @@
 #include "widgets/Notebook.hpp"
 
 #include "Application.hpp"
+#include "common/Channel.hpp"
 #include "common/QLogging.hpp"
 #include "controllers/hotkeys/HotkeyCategory.hpp"
 #include "controllers/hotkeys/HotkeyController.hpp"
+#include "messages/Message.hpp"
 #include "singletons/Settings.hpp"
 #include "singletons/Theme.hpp"
 #include "singletons/WindowManager.hpp"
@@ -26,6 +28,8 @@
 #include <QUuid>
 #include <QWidget>
 
+#include <algorithm>
+
 namespace chatterino {
 
 Notebook::Notebook(QWidget *parent)
@@ -1087,6 +1091,18 @@ SplitNotebook::SplitNotebook(Window *parent)
             {
                 if (auto sc = dynamic_cast<SplitContainer *>(item.page))
                 {
+                    // Tabs that weren't shown yet have no views to scroll
+                    auto channels = sc->getChannels();
+                    if (sc->getPendingDescriptor() &&
+                        std::any_of(channels.begin(), channels.end(),
+                                    [&message](const ChannelPtr &channel) {
+                                        return channel->getName() ==
+                                               message->channelName;
+                                    }))
+                    {
+                        sc->createPendingSplits();
+                    }
+
                     for (auto *split : sc->getSplits())
                     {
                         if (split->getChannel()->getType() !=
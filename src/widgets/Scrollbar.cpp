@@ -46,6 +46,12 @@ void Scrollbar::replaceHighlight(size_t index, ScrollbarHighlight replacement)
     this->highlights_.replaceItem(index, replacement);
 }
 
+void Scrollbar::removeFirstHighlight()
+{
+    ScrollbarHighlight removed;
+    this->highlights_.popFront(removed);
+}
+
 void Scrollbar::pauseHighlights()
 {
     this->highlightsPaused_ = true;
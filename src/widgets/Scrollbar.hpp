@@ -24,6 +24,7 @@ public:
     void addHighlightsAtStart(
         const std::vector<ScrollbarHighlight> &highlights_);
     void replaceHighlight(size_t index, ScrollbarHighlight replacement);
+    void removeFirstHighlight();
 
     void pauseHighlights();
     void unpauseHighlights();
@@ -15,6 +15,8 @@
 #include "widgets/splits/SplitContainer.hpp"
 #include "widgets/Window.hpp"
 
+#include <algorithm>
+
 namespace chatterino {
 
 namespace {
@@ -92,6 +94,22 @@ void QuickSwitcherPopup::updateSuggestions(const QString &text)
         const QString &tabTitle = sc->getTab()->getTitle();
         const auto splits = sc->getSplits();
 
+        // Tabs that weren't shown yet have no splits, switch to the tab
+        if (sc->getPendingDescriptor())
+        {
+            const auto channels = sc->getChannels();
+            if (std::any_of(channels.begin(), channels.end(),
+                            [&text](const auto &channel) {
+                                return channel->getName().contains(
+                                    text, Qt::CaseInsensitive);
+                            }))
+            {
+                auto item = std::make_unique<SwitchSplitItem>(sc);
+                this->switcherModel_.addItem(std::move(item));
+                continue;
+            }
+        }
+
         // First, check for splits on this page
         for (auto *split : splits)
         {
@@ -22,6 +22,7 @@
 #include "singletons/Theme.hpp"
 #include "singletons/WindowManager.hpp"
 #include "util/Clipboard.hpp"
+#include "util/DebugCount.hpp"
 #include "util/DistanceBetweenPoints.hpp"
 #include "util/Helpers.hpp"
 #include "util/IncognitoBrowser.hpp"
@@ -30,7 +31,10 @@
 #include "widgets/dialogs/ReplyThreadPopup.hpp"
 #include "widgets/dialogs/SettingsDialog.hpp"
 #include "widgets/dialogs/UserInfoPopup.hpp"
+#include "widgets/helper/ChannelViewRegistry.hpp"
 #include "widgets/helper/EffectLabel.hpp"
+#include "widgets/helper/FrameScheduler.hpp"
+#include "widgets/helper/PopMessagesUpTo.hpp"
 #include "widgets/helper/SearchPopup.hpp"
 #include "widgets/Scrollbar.hpp"
 #include "widgets/splits/Split.hpp"
@@ -44,6 +48,7 @@
 #include <QDebug>
 #include <QDesktopServices>
 #include <QEasingCurve>
+#include <QElapsedTimer>
 #include <QGraphicsBlurEffect>
 #include <QMessageBox>
 #include <QPainter>
@@ -62,6 +67,10 @@
 
 namespace chatterino {
 namespace {
+    // Layouts of messages this far above the viewport release their elements
+    constexpr size_t RELEASE_DISTANCE = 200;
+    constexpr int RELEASE_INTERVAL = 60 * 1000;
+
     void addEmoteContextMenuItems(const Emote &emote,
                                   MessageElementFlags creatorFlags, QMenu &menu)
     {
@@ -136,6 +145,12 @@ namespace {
         }
         return 1.0 + pow((20.0 / 9.0) * (0.5 * progress - 0.5), 3.0);
     }
+
+    ChannelViewRegistry<ChannelView> &viewRegistry()
+    {
+        static auto *registry = new ChannelViewRegistry<ChannelView>;
+        return *registry;
+    }
 }  // namespace
 
 ChannelView::ChannelView(BaseWidget *parent, Split *split, Context context,
@@ -146,7 +161,11 @@ ChannelView::ChannelView(BaseWidget *parent, Split *split, Context context,
     , highlightAnimation_(this)
     , context_(context)
     , messages_(messagesLimit)
+    , hiddenMessages_(messagesLimit)
 {
+    this->frameSerial_ = FrameScheduler::instance().registerView();
+    viewRegistry().add(this);
+
     this->setMouseTracking(true);
 
     this->initializeLayout();
@@ -166,6 +185,11 @@ ChannelView::ChannelView(BaseWidget *parent, Split *split, Context context,
         this->updatePauses();
     });
 
+    QObject::connect(&this->releaseTimer_, &QTimer::timeout, this, [this] {
+        this->releaseDistantLayouts();
+    });
+    this->releaseTimer_.start(RELEASE_INTERVAL);
+
     // This shortcut is not used in splits, it's used in views that
     // don't have a SplitInput like the SearchPopup or EmotePopup.
     // See SplitInput::installKeyPressedEvent for the copy event
@@ -197,6 +221,16 @@ ChannelView::ChannelView(BaseWidget *parent, Split *split, Context context,
     this->highlightAnimation_.setEasingCurve(curve);
 }
 
+ChannelView::~ChannelView()
+{
+    viewRegistry().remove(this);
+}
+
+void ChannelView::requestLayout(const Channel *channel)
+{
+    viewRegistry().requestLayout(channel);
+}
+
 void ChannelView::initializeLayout()
 {
     this->goToBottom_ = new EffectLabel(this, 0);
@@ -238,18 +272,9 @@ void ChannelView::initializeSignals()
 
     this->signalHolder_.managedConnect(getApp()->windows->gifRepaintRequested,
                                        [&] {
-                                           this->queueUpdate();
+                                           this->repaintGifEmotes();
                                        });
 
-    this->signalHolder_.managedConnect(
-        getApp()->windows->layoutRequested, [&](Channel *channel) {
-            if (this->isVisible() &&
-                (channel == nullptr || this->channel_.get() == channel))
-            {
-                this->queueLayout();
-            }
-        });
-
     this->signalHolder_.managedConnect(getApp()->fonts->fontChanged, [this] {
         this->queueLayout();
     });
@@ -399,33 +424,82 @@ void ChannelView::scaleChangedEvent(float scale)
 
 void ChannelView::queueUpdate()
 {
-    //    if (this->updateTimer.isActive()) {
-    //        this->updateQueued = true;
-    //        return;
-    //    }
+    FrameScheduler::instance().requestUpdate(this, this->frameSerial_);
+}
+
+void ChannelView::repaintGifEmotes()
+{
+    if (!this->isVisible())
+    {
+        return;
+    }
 
-    //    this->repaint();
+    auto &messagesSnapshot = this->getMessagesSnapshot();
 
-    this->update();
+    size_t start = size_t(this->scrollBar_->getCurrentValue());
 
-    //    this->updateTimer.start();
+    if (start >= messagesSnapshot.size())
+    {
+        return;
+    }
+
+    // Same positions as in drawMessages
+    int y = int(-(messagesSnapshot[start].get()->getHeight() *
+                  (fmod(this->scrollBar_->getCurrentValue(), 1))));
+
+    QRegion region;
+    for (size_t i = start; i < messagesSnapshot.size(); ++i)
+    {
+        MessageLayout *layout = messagesSnapshot[i].get();
+        layout->addAnimatedRegion(region, y);
+
+        y += layout->getHeight();
+        if (y > this->height())
+        {
+            break;
+        }
+    }
+
+    if (!region.isEmpty())
+    {
+        this->update(region);
+    }
 }
 
 void ChannelView::queueLayout()
 {
-    //    if (!this->layoutCooldown->isActive()) {
-    this->performLayout();
+    if (!this->isVisible())
+    {
+        // Laid out in showEvent
+        this->layoutQueuedWhileHidden_ = true;
+        return;
+    }
+
+    FrameScheduler::instance().requestLayout(this, this->frameSerial_);
+}
+
+void ChannelView::layoutBeforePaint()
+{
+    if (!this->isVisible())
+    {
+        this->queueLayout();
+        return;
+    }
 
-    //        this->layoutCooldown->start();
-    //    } else {
-    //        this->layoutQueued = true;
-    //    }
+    auto &scheduler = FrameScheduler::instance();
+    scheduler.takeLayout(this->frameSerial_);
+    this->performLayout();
+    // Qt repaints the whole view after this event anyway
+    scheduler.takeUpdate(this->frameSerial_);
 }
 
 void ChannelView::performLayout(bool causedByScrollbar)
 {
     // BenchmarkGuard benchmark("layout");
 
+    // Message heights may change, the next paint rebuilds the hit index
+    this->messageHitIndex_.bottoms.clear();
+
     /// Get messages and check if there are at least 1
     const auto &messages = this->getMessagesSnapshot();
 
@@ -537,6 +611,8 @@ void ChannelView::clearMessages()
 {
     // Clear all stored messages in this chat widget
     this->messages_.clear();
+    this->hiddenMessages_.clear();
+    this->hasHiddenMessages_ = false;
     this->scrollBar_->clearHighlights();
     this->queueLayout();
 
@@ -656,8 +732,18 @@ void ChannelView::setChannel(ChannelPtr underlyingChannel)
     this->scrollBar_->clearHighlights();
 
     /// make copy of channel and expose
-    this->channel_ = std::make_unique<Channel>(underlyingChannel->getName(),
-                                               underlyingChannel->getType());
+    this->channel_ = std::make_unique<Channel>(
+        underlyingChannel->getName(), underlyingChannel->getType(),
+        underlyingChannel->getMessageLimit());
+
+    auto snapshot = underlyingChannel->getMessageSnapshot();
+    if (this->isAggregateView())
+    {
+        // Views on /mentions and /live drop the messages their proxy channel
+        // drops, so it starts with the same messages as the view
+        this->channel_->addMessagesAtStart(
+            std::vector<MessagePtr>(snapshot.begin(), snapshot.end()));
+    }
 
     //
     // Proxy channel connections
@@ -735,7 +821,24 @@ void ChannelView::setChannel(ChannelPtr underlyingChannel)
         this->channel_->messageAppended,
         [this](MessagePtr &message,
                boost::optional<MessageFlags> overridingFlags) {
+            QElapsedTimer timer;
+            timer.start();
+
+            bool hidden = !this->isVisible();
             this->messageAppended(message, std::move(overridingFlags));
+
+            if (hidden)
+            {
+                DebugCount::increase("hidden view messages");
+                DebugCount::increase("hidden view message time (ns)",
+                                     timer.nsecsElapsed());
+            }
+            else
+            {
+                DebugCount::increase("visible view messages");
+                DebugCount::increase("visible view message time (ns)",
+                                     timer.nsecsElapsed());
+            }
         });
 
     this->channelConnections_.managedConnect(
@@ -763,8 +866,6 @@ void ChannelView::setChannel(ChannelPtr underlyingChannel)
                                                  this->messagesUpdated();
                                              });
 
-    auto snapshot = underlyingChannel->getMessageSnapshot();
-
     for (const auto &msg : snapshot)
     {
         auto messageLayout = std::make_shared<MessageLayout>(msg);
@@ -789,6 +890,7 @@ void ChannelView::setChannel(ChannelPtr underlyingChannel)
     }
 
     this->underlyingChannel_ = underlyingChannel;
+    viewRegistry().setChannel(this, underlyingChannel.get());
 
     this->queueLayout();
     this->queueUpdate();
@@ -862,6 +964,53 @@ void ChannelView::messageAppended(MessagePtr &message,
         messageFlags = overridingFlags.get_ptr();
     }
 
+    if (this->isVisible())
+    {
+        if (!this->scrollBar_->isAtBottom() &&
+            this->scrollBar_->getCurrentValueAnimation().state() ==
+                QPropertyAnimation::Running)
+        {
+            QEventLoop loop;
+
+            connect(&this->scrollBar_->getCurrentValueAnimation(),
+                    &QAbstractAnimation::stateChanged, &loop,
+                    &QEventLoop::quit);
+
+            loop.exec();
+        }
+
+        this->appendMessageLayout(message);
+    }
+    else
+    {
+        // Only keep the message, the layout is created once we're shown
+        this->hiddenMessages_.pushBack(message);
+        this->hasHiddenMessages_ = true;
+    }
+
+    if (!messageFlags->has(MessageFlag::DoNotTriggerNotification))
+    {
+        if (messageFlags->has(MessageFlag::Highlighted) &&
+            messageFlags->has(MessageFlag::ShowInMentions) &&
+            !messageFlags->has(MessageFlag::Subscription) &&
+            (getSettings()->highlightMentions ||
+             this->channel_->getType() != Channel::Type::TwitchMentions))
+
+        {
+            this->tabHighlightRequested.invoke(HighlightState::Highlighted);
+        }
+        else
+        {
+            this->tabHighlightRequested.invoke(HighlightState::NewMessage);
+        }
+    }
+
+    this->messageWasAdded_ = true;
+    this->queueLayout();
+}
+
+void ChannelView::appendMessageLayout(const MessagePtr &message)
+{
     auto messageRef = std::make_shared<MessageLayout>(message);
 
     if (this->lastMessageHasAlternateBackground_)
@@ -875,18 +1024,6 @@ void ChannelView::messageAppended(MessagePtr &message,
     this->lastMessageHasAlternateBackground_ =
         !this->lastMessageHasAlternateBackground_;
 
-    if (!this->scrollBar_->isAtBottom() &&
-        this->scrollBar_->getCurrentValueAnimation().state() ==
-            QPropertyAnimation::Running)
-    {
-        QEventLoop loop;
-
-        connect(&this->scrollBar_->getCurrentValueAnimation(),
-                &QAbstractAnimation::stateChanged, &loop, &QEventLoop::quit);
-
-        loop.exec();
-    }
-
     if (this->messages_.pushBack(messageRef))
     {
         if (this->paused())
@@ -903,34 +1040,34 @@ void ChannelView::messageAppended(MessagePtr &message,
         }
     }
 
-    if (!messageFlags->has(MessageFlag::DoNotTriggerNotification))
+    if (this->showScrollbarHighlights())
     {
-        if (messageFlags->has(MessageFlag::Highlighted) &&
-            messageFlags->has(MessageFlag::ShowInMentions) &&
-            !messageFlags->has(MessageFlag::Subscription) &&
-            (getSettings()->highlightMentions ||
-             this->channel_->getType() != Channel::Type::TwitchMentions))
+        this->scrollBar_->addHighlight(message->getScrollBarHighlight());
+    }
+}
 
-        {
-            this->tabHighlightRequested.invoke(HighlightState::Highlighted);
-        }
-        else
-        {
-            this->tabHighlightRequested.invoke(HighlightState::NewMessage);
-        }
+void ChannelView::flushHiddenMessages()
+{
+    if (!this->hasHiddenMessages_)
+    {
+        return;
     }
 
-    if (this->showScrollbarHighlights())
+    for (const auto &message : this->hiddenMessages_.getSnapshot())
     {
-        this->scrollBar_->addHighlight(message->getScrollBarHighlight());
+        this->appendMessageLayout(message);
     }
 
-    this->messageWasAdded_ = true;
+    this->hiddenMessages_.clear();
+    this->hasHiddenMessages_ = false;
     this->queueLayout();
 }
 
 void ChannelView::messageAddedAtStart(std::vector<MessagePtr> &messages)
 {
+    // Keep the order of the messages
+    this->flushHiddenMessages();
+
     std::vector<MessageLayoutPtr> messageRefs;
     messageRefs.resize(messages.size());
 
@@ -976,6 +1113,13 @@ void ChannelView::messageAddedAtStart(std::vector<MessagePtr> &messages)
 
 void ChannelView::messageRemoveFromStart(MessagePtr &message)
 {
+    if (this->isAggregateView())
+    {
+        // Views on /mentions and /live don't keep messages around longer
+        // than their channel, so they can be freed
+        this->dropMessagesUpTo(message);
+    }
+
     if (this->paused())
     {
         this->pauseSelectionOffset_ += 1;
@@ -990,6 +1134,9 @@ void ChannelView::messageRemoveFromStart(MessagePtr &message)
 
 void ChannelView::messageReplaced(size_t index, MessagePtr &replacement)
 {
+    // The index refers to the messages including the hidden ones
+    this->flushHiddenMessages();
+
     auto oMessage = this->messages_.get(index);
     if (!oMessage)
     {
@@ -1016,6 +1163,10 @@ void ChannelView::messagesUpdated()
 {
     auto snapshot = this->channel_->getMessageSnapshot();
 
+    // The snapshot already contains the hidden messages
+    this->hiddenMessages_.clear();
+    this->hasHiddenMessages_ = false;
+
     this->messages_.clear();
     this->scrollBar_->clearHighlights();
     this->lastMessageHasAlternateBackground_ = false;
@@ -1067,7 +1218,7 @@ void ChannelView::resizeEvent(QResizeEvent *)
 
     this->scrollBar_->raise();
 
-    this->queueLayout();
+    this->layoutBeforePaint();
 
     this->update();
 }
@@ -1145,6 +1296,77 @@ MessageElementFlags ChannelView::getFlags() const
     return flags;
 }
 
+void ChannelView::releaseDistantLayouts()
+{
+    if (getSettings()->messageCompactionAge <= 0)
+    {
+        return;
+    }
+
+    auto start = size_t(this->scrollBar_->getCurrentValue());
+    if (start <= RELEASE_DISTANCE)
+    {
+        return;
+    }
+
+    // Selected text is copied from the layouts, so they're kept. While
+    // paused, the selection isn't shifted for the removed messages yet.
+    size_t selectionMin = this->selection_.selectionMin.messageIndex;
+    size_t selectionMax = this->selection_.selectionMax.messageIndex;
+    selectionMin -= std::min<size_t>(selectionMin, this->pauseSelectionOffset_);
+
+    auto messages = this->messages_.getSnapshot();
+    auto end = std::min(start - RELEASE_DISTANCE, messages.size());
+    for (size_t i = 0; i < end; ++i)
+    {
+        if (!this->selection_.isEmpty() && i >= selectionMin &&
+            i <= selectionMax)
+        {
+            continue;
+        }
+
+        messages[i]->releaseElements();
+    }
+}
+
+void ChannelView::dropMessagesUpTo(const MessagePtr &message)
+{
+    auto hiddenSpace = this->hiddenMessages_.space();
+    auto dropCount =
+        popMessagesUpTo(this->messages_, this->hiddenMessages_, message);
+    if (this->hiddenMessages_.space() != hiddenSpace)
+    {
+        this->hasHiddenMessages_ = !this->hiddenMessages_.empty();
+    }
+
+    for (size_t i = 0; i < dropCount; ++i)
+    {
+        if (this->showScrollbarHighlights())
+        {
+            this->scrollBar_->removeFirstHighlight();
+        }
+
+        if (this->paused())
+        {
+            if (!this->scrollBar_->isAtBottom())
+                this->pauseScrollOffset_--;
+        }
+        else
+        {
+            if (this->scrollBar_->isAtBottom())
+                this->scrollBar_->scrollToBottom();
+            else
+                this->scrollBar_->offset(-1);
+        }
+    }
+}
+
+bool ChannelView::isAggregateView() const
+{
+    return this->channel_->getType() == Channel::Type::TwitchMentions ||
+           this->channel_->getType() == Channel::Type::TwitchLive;
+}
+
 bool ChannelView::scrollToMessage(const MessagePtr &message)
 {
     if (!this->mayContainMessage(message))
@@ -1152,6 +1374,8 @@ bool ChannelView::scrollToMessage(const MessagePtr &message)
         return false;
     }
 
+    this->flushHiddenMessages();
+
     auto &messagesSnapshot = this->getMessagesSnapshot();
     if (messagesSnapshot.size() == 0)
     {
@@ -1185,6 +1409,8 @@ bool ChannelView::scrollToMessage(const MessagePtr &message)
 
 bool ChannelView::scrollToMessageId(const QString &messageId)
 {
+    this->flushHiddenMessages();
+
     auto &messagesSnapshot = this->getMessagesSnapshot();
     if (messagesSnapshot.size() == 0)
     {
@@ -1229,6 +1455,14 @@ void ChannelView::paintEvent(QPaintEvent * /*event*/)
 {
     //    BenchmarkGuard benchmark("paint");
 
+    // Frame times while drag-selecting show up in the debug popup
+    QElapsedTimer selectionFrameTimer;
+    bool isDragSelecting = this->isLeftMouseDown_ && this->selecting_;
+    if (isDragSelecting)
+    {
+        selectionFrameTimer.start();
+    }
+
     QPainter painter(this);
 
     painter.fillRect(rect(), this->theme->splits.background);
@@ -1244,6 +1478,13 @@ void ChannelView::paintEvent(QPaintEvent * /*event*/)
         painter.fillRect(QRectF(5, a / 4, a / 4, a), brush);
         painter.fillRect(QRectF(15, a / 4, a / 4, a), brush);
     }
+
+    if (isDragSelecting)
+    {
+        DebugCount::increase("selection frames");
+        DebugCount::increase("selection frame time (us)",
+                             selectionFrameTimer.nsecsElapsed() / 1000);
+    }
 }
 
 // if overlays is false then it draws the message, if true then it draws things
@@ -1268,6 +1509,13 @@ void ChannelView::drawMessages(QPainter &painter)
     auto app = getApp();
     bool isMentions = this->underlyingChannel_ == app->twitch->mentionsChannel;
 
+    auto &hitIndex = this->messageHitIndex_;
+    hitIndex.scrollValue = this->scrollBar_->getCurrentValue();
+    hitIndex.first = messagesSnapshot[start].get();
+    hitIndex.start = start;
+    hitIndex.top = y;
+    hitIndex.bottoms.clear();
+
     for (size_t i = start; i < messagesSnapshot.size(); ++i)
     {
         MessageLayout *layout = messagesSnapshot[i].get();
@@ -1293,6 +1541,7 @@ void ChannelView::drawMessages(QPainter &painter)
         }
 
         y += layout->getHeight();
+        hitIndex.bottoms.push_back(y);
 
         end = layout;
         if (y > this->height())
@@ -1684,8 +1933,13 @@ void ChannelView::mouseMoveEvent(QMouseEvent *event)
         }
         else
         {
-            if (element->getTooltip() == "No link info loaded")
+            if (element->getTooltip() == "No link info loaded" &&
+                (element != this->linkInfoElement_ ||
+                 element->getLink().value != this->linkInfoLink_))
             {
+                this->linkInfoElement_ = element;
+                this->linkInfoLink_ = element->getLink().value;
+
                 std::weak_ptr<MessageLayout> weakLayout = layout;
                 LinkResolver::getLinkInfo(
                     element->getLink().value, nullptr,
@@ -1697,6 +1951,16 @@ void ChannelView::mouseMoveEvent(QMouseEvent *event)
                             return;
                         element->setTooltip(tooltipText);
                         element->setThumbnail(thumbnail);
+                        element->setThumbnailType(
+                            MessageElement::ThumbnailType::Link_Thumbnail);
+
+                        // Same as MessageBuilder::addLink, originalLink is
+                        // only unshortened if unshortLinks is enabled
+                        if (originalLink.value != element->getLink().value &&
+                            !originalLink.value.isEmpty())
+                        {
+                            element->setLink(originalLink)->updateLink();
+                        }
                     });
             }
             auto thumbnailSize = getSettings()->thumbnailSize;
@@ -2475,8 +2739,24 @@ void ChannelView::mouseDoubleClickEvent(QMouseEvent *event)
     }
 }
 
+void ChannelView::showEvent(QShowEvent *event)
+{
+    BaseWidget::showEvent(event);
+
+    this->flushHiddenMessages();
+
+    auto layoutRequested = viewRegistry().setVisible(this, true);
+    if (this->layoutQueuedWhileHidden_ || layoutRequested)
+    {
+        this->layoutQueuedWhileHidden_ = false;
+        this->layoutBeforePaint();
+    }
+}
+
 void ChannelView::hideEvent(QHideEvent *)
 {
+    viewRegistry().setVisible(this, false);
+
     for (auto &layout : this->messagesOnScreen_)
     {
         layout->deleteBuffer();
@@ -2611,6 +2891,17 @@ void ChannelView::handleLinkClick(QMouseEvent *event, const Link &link,
 
             for (auto *page : openPages)
             {
+                // Tabs that weren't shown yet only know their channels
+                auto channels = page->getChannels();
+                if (page->getPendingDescriptor() &&
+                    std::any_of(channels.begin(), channels.end(),
+                                [&link](const ChannelPtr &channel) {
+                                    return channel->getName() == link.value;
+                                }))
+                {
+                    page->createPendingSplits();
+                }
+
                 auto splits = page->getSplits();
 
                 // Search for channel matching link in page/split container
@@ -2682,6 +2973,28 @@ bool ChannelView::tryGetMessageAt(QPoint p,
         return false;
     }
 
+    // Use the positions of the last paint if they still apply
+    const auto &hitIndex = this->messageHitIndex_;
+    if (hitIndex.scrollValue == this->scrollBar_->getCurrentValue() &&
+        hitIndex.start == start &&
+        hitIndex.first == messagesSnapshot[start].get() &&
+        !hitIndex.bottoms.empty() && p.y() < hitIndex.bottoms.back())
+    {
+        auto it = std::upper_bound(hitIndex.bottoms.begin(),
+                                   hitIndex.bottoms.end(), p.y());
+        auto offset = size_t(it - hitIndex.bottoms.begin());
+
+        if (start + offset < messagesSnapshot.size())
+        {
+            int top = offset == 0 ? hitIndex.top : hitIndex.bottoms[offset - 1];
+
+            relativePos = QPoint(p.x(), p.y() - top);
+            _message = messagesSnapshot[start + offset];
+            index = int(start + offset);
+            return true;
+        }
+    }
+
     int y = -(messagesSnapshot[start]->getHeight() *
               (fmod(this->scrollBar_->getCurrentValue(), 1)));
 
@@ -2798,17 +3111,14 @@ void ChannelView::setInputReply(const MessagePtr &message)
     if (message->replyThread == nullptr)
     {
         auto getThread = [&](TwitchChannel *tc) {
-            auto threadIt = tc->threads().find(message->id);
-            if (threadIt != tc->threads().end() && !threadIt->second.expired())
-            {
-                return threadIt->second.lock();
-            }
-            else
+            if (auto thread = tc->getReplyThread(message->id))
             {
-                auto thread = std::make_shared<MessageThread>(message);
-                tc->addReplyThread(thread);
                 return thread;
             }
+
+            auto thread = std::make_shared<MessageThread>(message);
+            tc->addReplyThread(thread);
+            return thread;
         };
 
         if (auto tc =
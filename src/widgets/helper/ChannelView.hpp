@@ -19,6 +19,7 @@
 
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 namespace chatterino {
 enum class HighlightState;
@@ -41,6 +42,7 @@ using MessageElementFlags = FlagsEnum<MessageElementFlag>;
 class Scrollbar;
 class EffectLabel;
 struct Link;
+class MessageElement;
 class MessageLayoutElement;
 class Split;
 
@@ -75,8 +77,16 @@ public:
     explicit ChannelView(BaseWidget *parent = nullptr, Split *split = nullptr,
                          Context context = Context::None,
                          size_t messagesLimit = 1000);
+    ~ChannelView() override;
 
+    /// Lays out the views displaying `channel`, or all views if it's nullptr.
+    /// Views that are hidden are laid out once they're shown.
+    static void requestLayout(const Channel *channel);
+
+    /// Repaints the view in the next frame, see FrameScheduler
     void queueUpdate();
+    /// Repaints only the animated emotes that advanced to a new frame
+    void repaintGifEmotes();
     Scrollbar &getScrollBar();
 
     QString getSelectedText();
@@ -127,6 +137,7 @@ public:
     bool hasSourceChannel() const;
 
     LimitedQueueSnapshot<MessageLayoutPtr> &getMessagesSnapshot();
+    /// Lays out the view in the next frame, see FrameScheduler
     void queueLayout();
 
     void clearMessages();
@@ -174,6 +185,7 @@ protected:
     void mouseReleaseEvent(QMouseEvent *event) override;
     void mouseDoubleClickEvent(QMouseEvent *event) override;
 
+    void showEvent(QShowEvent *) override;
     void hideEvent(QHideEvent *) override;
 
     void handleLinkClick(QMouseEvent *event, const Link &link,
@@ -183,6 +195,8 @@ protected:
                          QPoint &relativePos, int &index);
 
 private:
+    friend class FrameScheduler;
+
     void initializeLayout();
     void initializeScrollbar();
     void initializeSignals();
@@ -193,8 +207,23 @@ private:
     void messageRemoveFromStart(MessagePtr &message);
     void messageReplaced(size_t index, MessagePtr &replacement);
     void messagesUpdated();
+    // Lets the messages far above the viewport be compacted
+    void releaseDistantLayouts();
+    // Whether this view shows /mentions or /live
+    bool isAggregateView() const;
+    // Drops the message and everything before it, whether it's laid out or
+    // still hidden
+    void dropMessagesUpTo(const MessagePtr &message);
+
+    // Creates the layout for `message` and scrolls to keep the position
+    void appendMessageLayout(const MessagePtr &message);
+    // Creates the layouts of messages that arrived while the view was hidden
+    void flushHiddenMessages();
 
     void performLayout(bool causedByScrollbar = false);
+    // Lays out right away instead of in the next frame, for events that Qt
+    // repaints the view after anyway
+    void layoutBeforePaint();
     void layoutVisibleMessages(
         const LimitedQueueSnapshot<MessageLayoutPtr> &messages);
     void updateScrollbar(const LimitedQueueSnapshot<MessageLayoutPtr> &messages,
@@ -250,15 +279,14 @@ private:
     void showReplyThreadPopup(const MessagePtr &message);
     bool canReplyToMessages() const;
 
-    QTimer *layoutCooldown_;
-    bool layoutQueued_;
-
-    QTimer updateTimer_;
-    bool updateQueued_ = false;
+    // Orders this view in the FrameScheduler
+    uint64_t frameSerial_;
     bool messageWasAdded_ = false;
     bool lastMessageHasAlternateBackground_ = false;
     bool lastMessageHasAlternateBackgroundReverse_ = true;
 
+    QTimer releaseTimer_;
+
     bool pausable_ = false;
     QTimer pauseTimer_;
     std::unordered_map<PauseReason, boost::optional<SteadyClock::time_point>>
@@ -307,6 +335,10 @@ private:
     QPointF lastRightPressPosition_;
     QPointF lastDClickPosition_;
     QTimer *clickTimer_;
+    // The element whose link info was looked up last. Hovering it again
+    // doesn't look it up again while the lookup is pending.
+    const MessageElement *linkInfoElement_ = nullptr;
+    QString linkInfoLink_;
 
     bool isScrolling_ = false;
     QPointF lastMiddlePressPosition_;
@@ -331,6 +363,13 @@ private:
 
     LimitedQueue<MessageLayoutPtr> messages_;
 
+    // Messages appended while the view was hidden. Their layouts are only
+    // created once the view is shown again.
+    LimitedQueue<MessagePtr> hiddenMessages_;
+    bool hasHiddenMessages_ = false;
+    // Set when a layout was requested while the view was hidden
+    bool layoutQueuedWhileHidden_ = false;
+
     pajlada::Signals::SignalHolder signalHolder_;
 
     // channelConnections_ will be cleared when the underlying channel of the channelview changes
@@ -338,6 +377,18 @@ private:
 
     std::unordered_set<std::shared_ptr<MessageLayout>> messagesOnScreen_;
 
+    // Positions of the messages drawn by the last paint, used by
+    // tryGetMessageAt to find the message under the cursor with a binary
+    // search. Only valid while the scroll position and first message match.
+    struct {
+        double scrollValue = -1;
+        const MessageLayout *first = nullptr;
+        size_t start = 0;
+        int top = 0;
+        // Prefix sums of the message heights, starting at `top`
+        std::vector<int> bottoms;
+    } messageHitIndex_;
+
     static constexpr int leftPadding = 8;
     static constexpr int scrollbarPadding = 8;
 
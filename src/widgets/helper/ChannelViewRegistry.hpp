@@ -0,0 +1,161 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace chatterino {
+
+class Channel;
+
+/// ChannelViewRegistry keeps track of which views display which channel and
+/// which views are visible, so layout requests only reach the views they
+/// concern.
+///
+/// Visible views are laid out right away through View::queueLayout. Hidden
+/// views only remember that they need a layout, setVisible reports it once
+/// they're shown again. Requests for all channels don't touch hidden views
+/// at all, they compare a generation counter when they're shown.
+///
+/// This class is not thread-safe.
+template <typename View>
+class ChannelViewRegistry
+{
+public:
+    /// Adds a hidden view that doesn't display a channel yet
+    void add(View *view)
+    {
+        this->entries_.emplace(view, Entry{nullptr, false, false,
+                                           this->globalGeneration_});
+    }
+
+    void remove(View *view)
+    {
+        auto it = this->entries_.find(view);
+        if (it == this->entries_.end())
+        {
+            return;
+        }
+
+        this->removeFromChannel(view, it->second.channel);
+        this->visible_.erase(view);
+        this->entries_.erase(it);
+    }
+
+    void setChannel(View *view, const Channel *channel)
+    {
+        auto &entry = this->entries_.at(view);
+        if (entry.channel == channel)
+        {
+            return;
+        }
+
+        this->removeFromChannel(view, entry.channel);
+        entry.channel = channel;
+        if (channel != nullptr)
+        {
+            this->byChannel_[channel].push_back(view);
+        }
+    }
+
+    /// Returns true if a layout was requested while the view was hidden
+    bool setVisible(View *view, bool visible)
+    {
+        auto &entry = this->entries_.at(view);
+        if (entry.visible == visible)
+        {
+            return false;
+        }
+        entry.visible = visible;
+
+        if (!visible)
+        {
+            this->visible_.erase(view);
+            entry.seenGeneration = this->globalGeneration_;
+            return false;
+        }
+
+        this->visible_.insert(view);
+
+        auto layoutRequested = entry.layoutRequested ||
+                               entry.seenGeneration != this->globalGeneration_;
+        entry.layoutRequested = false;
+        return layoutRequested;
+    }
+
+    /// Lays out the views displaying `channel`, or all views if it's nullptr
+    void requestLayout(const Channel *channel)
+    {
+        if (channel == nullptr)
+        {
+            this->globalGeneration_++;
+            for (auto *view : this->visible_)
+            {
+                view->queueLayout();
+            }
+            return;
+        }
+
+        auto it = this->byChannel_.find(channel);
+        if (it == this->byChannel_.end())
+        {
+            return;
+        }
+
+        for (auto *view : it->second)
+        {
+            auto &entry = this->entries_.at(view);
+            if (entry.visible)
+            {
+                view->queueLayout();
+            }
+            else
+            {
+                entry.layoutRequested = true;
+            }
+        }
+    }
+
+    size_t viewCount(const Channel *channel) const
+    {
+        auto it = this->byChannel_.find(channel);
+        return it == this->byChannel_.end() ? 0 : it->second.size();
+    }
+
+private:
+    struct Entry {
+        const Channel *channel;
+        bool visible;
+        // A layout for this channel was requested while it was hidden
+        bool layoutRequested;
+        // globalGeneration_ when the view was hidden
+        uint64_t seenGeneration;
+    };
+
+    void removeFromChannel(View *view, const Channel *channel)
+    {
+        auto it = this->byChannel_.find(channel);
+        if (it == this->byChannel_.end())
+        {
+            return;
+        }
+
+        auto &views = it->second;
+        views.erase(std::remove(views.begin(), views.end(), view),
+                    views.end());
+        if (views.empty())
+        {
+            this->byChannel_.erase(it);
+        }
+    }
+
+    std::unordered_map<View *, Entry> entries_;
+    std::unordered_map<const Channel *, std::vector<View *>> byChannel_;
+    std::unordered_set<View *> visible_;
+    // Incremented by every request for all channels
+    uint64_t globalGeneration_ = 0;
+};
+
+}  // namespace chatterino
@@ -0,0 +1,143 @@
+#include "widgets/helper/FrameScheduler.hpp"
+
+#include "debug/AssertInGuiThread.hpp"
+#include "util/DebugCount.hpp"
+#include "widgets/helper/ChannelView.hpp"
+
+#include <QGuiApplication>
+#include <QScreen>
+
+#include <algorithm>
+#include <cmath>
+
+namespace chatterino {
+
+namespace {
+
+    // Used if the refresh rate of the screen is unknown
+    constexpr qreal DEFAULT_REFRESH_RATE = 60.0;
+
+}  // namespace
+
+FrameScheduler &FrameScheduler::instance()
+{
+    static auto *scheduler = new FrameScheduler;
+    return *scheduler;
+}
+
+FrameScheduler::FrameScheduler()
+{
+    this->timer_.setSingleShot(true);
+    this->timer_.setTimerType(Qt::PreciseTimer);
+    QObject::connect(&this->timer_, &QTimer::timeout, [this] {
+        this->runFrame();
+    });
+
+    this->clock_.start();
+}
+
+uint64_t FrameScheduler::registerView()
+{
+    return this->nextSerial_++;
+}
+
+void FrameScheduler::requestLayout(ChannelView *view, uint64_t serial)
+{
+    assertInGuiThread();
+
+    this->pendingLayouts_.emplace(serial, view);
+    this->schedule();
+}
+
+void FrameScheduler::requestUpdate(ChannelView *view, uint64_t serial)
+{
+    assertInGuiThread();
+
+    this->pendingUpdates_.emplace(serial, view);
+    this->schedule();
+}
+
+bool FrameScheduler::takeLayout(uint64_t serial)
+{
+    return this->pendingLayouts_.erase(serial) != 0;
+}
+
+bool FrameScheduler::takeUpdate(uint64_t serial)
+{
+    return this->pendingUpdates_.erase(serial) != 0;
+}
+
+void FrameScheduler::schedule()
+{
+    if (this->inFrame_ || this->timer_.isActive())
+    {
+        return;
+    }
+
+    // Wait for the start of the next frame
+    auto interval = this->frameInterval();
+    auto elapsed = int(this->clock_.elapsed() % interval);
+    this->timer_.start(interval - elapsed);
+}
+
+void FrameScheduler::runFrame()
+{
+    QElapsedTimer timer;
+    timer.start();
+    this->inFrame_ = true;
+
+    // Requests made while running this frame are handled in the next one,
+    // except for repaints caused by the layouts
+    auto layouts = std::move(this->pendingLayouts_);
+    this->pendingLayouts_.clear();
+
+    for (auto &[serial, view] : layouts)
+    {
+        if (view)
+        {
+            view->performLayout();
+        }
+    }
+
+    auto updates = std::move(this->pendingUpdates_);
+    this->pendingUpdates_.clear();
+
+    for (auto &[serial, view] : updates)
+    {
+        if (view)
+        {
+            view->repaint();
+        }
+    }
+
+    this->inFrame_ = false;
+
+    auto elapsedUs = timer.nsecsElapsed() / 1000;
+    DebugCount::increase("frames");
+    DebugCount::increase("frame time (us)", elapsedUs);
+    if (elapsedUs > this->frameInterval() * 1000)
+    {
+        DebugCount::increase("frame budget overruns");
+    }
+
+    if (!this->pendingLayouts_.empty() || !this->pendingUpdates_.empty())
+    {
+        this->schedule();
+    }
+}
+
+int FrameScheduler::frameInterval() const
+{
+    auto refreshRate = DEFAULT_REFRESH_RATE;
+    if (auto *screen = QGuiApplication::primaryScreen())
+    {
+        if (screen->refreshRate() > 1.0)
+        {
+            refreshRate = screen->refreshRate();
+        }
+    }
+
+    return std::max(1, int(std::lround(1000.0 / refreshRate)));
+}
+
+}  // namespace chatterino
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QPointer>
+#include <QTimer>
+
+#include <cstdint>
+#include <map>
+
+namespace chatterino {
+
+class ChannelView;
+
+/// FrameScheduler collects the layouts and repaints requested by all
+/// ChannelViews and runs them together once per frame.
+///
+/// Frames start at multiples of the primary screen's refresh interval. The
+/// timer only runs while something is pending. Views are laid out before
+/// any view is repainted, each in the order the views were created in.
+/// Views are repainted right away through QWidget::repaint, so the frame
+/// time in the debug popup includes painting. Frames that take longer than
+/// the refresh interval are counted as budget overruns.
+///
+/// Paints Qt starts on its own, like after a resize or when a window is
+/// exposed, still happen outside of frames.
+///
+/// This class must only be used from the GUI thread.
+class FrameScheduler
+{
+public:
+    static FrameScheduler &instance();
+
+    /// Returns a number that orders `view` among all views
+    uint64_t registerView();
+
+    void requestLayout(ChannelView *view, uint64_t serial);
+    void requestUpdate(ChannelView *view, uint64_t serial);
+
+    /// Removes the pending layout of the view with the serial `serial` and
+    /// returns true if there was one
+    bool takeLayout(uint64_t serial);
+    /// Removes the pending repaint of the view with the serial `serial` and
+    /// returns true if there was one
+    bool takeUpdate(uint64_t serial);
+
+private:
+    FrameScheduler();
+
+    void schedule();
+    void runFrame();
+    int frameInterval() const;
+
+    QTimer timer_;
+    QElapsedTimer clock_;
+    uint64_t nextSerial_ = 0;
+    bool inFrame_ = false;
+
+    std::map<uint64_t, QPointer<ChannelView>> pendingLayouts_;
+    std::map<uint64_t, QPointer<ChannelView>> pendingUpdates_;
+};
+
+}  // namespace chatterino
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "messages/LimitedQueue.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+
+namespace chatterino {
+
+struct Message;
+using MessagePtr = std::shared_ptr<const Message>;
+
+/// Pops `message` and everything before it from a view after its channel
+/// dropped them. Channels drop messages in the order they were added.
+///
+/// `hidden` holds the messages that arrived while the view was hidden. They're
+/// newer than all of `layouts`, so if `message` is one of them, all layouts
+/// are popped as well. Nothing is popped if the view doesn't hold `message`.
+///
+/// Returns the number of layouts popped from the front of `layouts`.
+template <typename LayoutPtr>
+size_t popMessagesUpTo(LimitedQueue<LayoutPtr> &layouts,
+                       LimitedQueue<MessagePtr> &hidden,
+                       const MessagePtr &message)
+{
+    auto snapshot = layouts.getSnapshot();
+    size_t popCount = 0;
+
+    auto hiddenSnapshot = hidden.getSnapshot();
+    auto hiddenIt =
+        std::find(hiddenSnapshot.begin(), hiddenSnapshot.end(), message);
+    if (hiddenIt != hiddenSnapshot.end())
+    {
+        for (auto it = hiddenSnapshot.begin(); it <= hiddenIt; ++it)
+        {
+            MessagePtr popped;
+            hidden.popFront(popped);
+        }
+
+        popCount = snapshot.size();
+    }
+    else
+    {
+        auto layoutIt = std::find_if(snapshot.begin(), snapshot.end(),
+                                     [&](const LayoutPtr &layout) {
+                                         return layout->getMessagePtr() ==
+                                                message;
+                                     });
+        if (layoutIt == snapshot.end())
+        {
+            return 0;
+        }
+        popCount = size_t(layoutIt - snapshot.begin()) + 1;
+    }
+
+    for (size_t i = 0; i < popCount; ++i)
+    {
+        LayoutPtr popped;
+        layouts.popFront(popped);
+    }
+
+    return popCount;
+}
+
+}  // namespace chatterino
@@ -494,6 +494,11 @@ void GeneralPage::initLayout(GeneralPageView &layout)
         "href=\"https://braize.pajlada.com/chatterino/legal/"
         "privacy-policy\">Privacy Policy</a>.");
     layout.addCheckbox("Enable", s.linkInfoTooltip);
+    layout.addCheckbox(
+        "Load link info of new messages in the background", s.linkInfoPrefetch,
+        false,
+        "When disabled, link info is only loaded once you hover over a "
+        "link.");
     layout.addDropdown<int>(
         "Also show thumbnails if available",
         {"Off", "Small", "Medium", "Large"}, s.thumbnailSize,
@@ -873,6 +878,10 @@ void GeneralPage::initLayout(GeneralPageView &layout)
                        s.scrollbackSplitLimit, 100, 100000, 100);
     layout.addIntInput("Usercard scrollback limit (requires restart)",
                        s.scrollbackUsercardLimit, 100, 100000, 100);
+    layout.addIntInput("Mentions and live scrollback limit (requires restart)",
+                       s.scrollbackAggregateLimit, 100, 100000, 100);
+    layout.addIntInput("Compact messages older than (minutes, 0 to disable)",
+                       s.messageCompactionAge, 0, 1440, 5);
 
     layout.addCheckbox("Enable experimental IRC support (requires restart)",
                        s.enableExperimentalIrc, false,
@@ -18,35 +18,21 @@ namespace {
 
 using namespace chatterino;
 
-struct CompletionEmote {
-    EmotePtr emote;
-    QString displayName;
-    QString providerName;
-};
-
-void addEmotes(std::vector<CompletionEmote> &out, const EmoteMap &map,
-               const QString &text, const QString &providerName)
+void addEmotes(EmoteCompletionTable &table, const EmoteMap &map,
+               const QString &providerName)
 {
     for (auto &&emote : map)
     {
-        if (emote.first.string.contains(text, Qt::CaseInsensitive))
-        {
-            out.push_back(
-                {emote.second, emote.second->name.string, providerName});
-        }
+        table.add(emote.second, emote.second->name.string, providerName);
     }
 }
 
-void addEmojis(std::vector<CompletionEmote> &out, const EmojiMap &map,
-               const QString &text)
+void addEmojis(EmoteCompletionTable &table, const EmojiMap &map)
 {
     map.each([&](const QString &, const std::shared_ptr<EmojiData> &emoji) {
         for (auto &&shortCode : emoji->shortCodes)
         {
-            if (shortCode.contains(text, Qt::CaseInsensitive))
-            {
-                out.push_back({emoji->emote, shortCode, "Emoji"});
-            }
+            table.add(emoji->emote, shortCode, "Emoji");
         }
     });
 }
@@ -72,94 +58,107 @@ InputCompletionPopup::InputCompletionPopup(QWidget *parent)
     this->redrawTimer_.setInterval(33);
 }
 
-void InputCompletionPopup::updateEmotes(const QString &text, ChannelPtr channel)
+bool InputCompletionPopup::EmoteSources::operator==(
+    const EmoteSources &other) const
 {
-    std::vector<CompletionEmote> emotes;
+    return this->account == other.account &&
+           this->emoteGeneration == other.emoteGeneration &&
+           this->roomId == other.roomId &&
+           this->maps == other.maps;
+}
+
+void InputCompletionPopup::refreshEmoteTable(const ChannelPtr &channel)
+{
+    EmoteSources sources;
     auto *tc = dynamic_cast<TwitchChannel *>(channel.get());
     // returns true also for special Twitch channels (/live, /mentions, /whispers, etc.)
     if (channel->isTwitchChannel())
     {
         if (auto user = getApp()->accounts->twitch.getCurrent())
         {
-            // Twitch Emotes available globally
-            auto emoteData = user->accessEmotes();
-            addEmotes(emotes, emoteData->emotes, text, "Twitch Emote");
-
-            // Twitch Emotes available locally
-            auto localEmoteData = user->accessLocalEmotes();
-            if (tc &&
-                localEmoteData->find(tc->roomId()) != localEmoteData->end())
-            {
-                if (const auto *localEmotes = &localEmoteData->at(tc->roomId()))
-                {
-                    addEmotes(emotes, *localEmotes, text,
-                              "Local Twitch Emotes");
-                }
-            }
+            sources.account = user;
+            sources.emoteGeneration = user->emoteGeneration();
         }
 
         if (tc)
         {
-            // TODO extract "Channel {BetterTTV,7TV,FrankerFaceZ}" text into a #define.
-            if (auto bttv = tc->bttvEmotes())
-            {
-                addEmotes(emotes, *bttv, text, "Channel BetterTTV");
-            }
-            if (auto ffz = tc->ffzEmotes())
-            {
-                addEmotes(emotes, *ffz, text, "Channel FrankerFaceZ");
-            }
-            if (auto seventv = tc->seventvEmotes())
-            {
-                addEmotes(emotes, *seventv, text, "Channel 7TV");
-            }
-        }
-
-        if (auto bttvG = getApp()->twitch->getBttvEmotes().emotes())
-        {
-            addEmotes(emotes, *bttvG, text, "Global BetterTTV");
-        }
-        if (auto ffzG = getApp()->twitch->getFfzEmotes().emotes())
-        {
-            addEmotes(emotes, *ffzG, text, "Global FrankerFaceZ");
+            sources.roomId = tc->roomId();
+            sources.maps = {tc->bttvEmotes(), tc->ffzEmotes(),
+                            tc->seventvEmotes()};
         }
-        if (auto seventvG = getApp()->twitch->getSeventvEmotes().globalEmotes())
+        else
         {
-            addEmotes(emotes, *seventvG, text, "Global 7TV");
+            sources.maps.resize(3);
         }
+        sources.maps.push_back(getApp()->twitch->getBttvEmotes().emotes());
+        sources.maps.push_back(getApp()->twitch->getFfzEmotes().emotes());
+        sources.maps.push_back(
+            getApp()->twitch->getSeventvEmotes().globalEmotes());
+    }
+
+    if (this->emoteSources_ && *this->emoteSources_ == sources)
+    {
+        return;
     }
 
-    addEmojis(emotes, getApp()->emotes->emojis.emojis, text);
+    this->emoteTable_.clear();
 
-    // if there is an exact match, put that emote first
-    for (size_t i = 1; i < emotes.size(); i++)
+    if (sources.account)
     {
-        auto emoteText = emotes.at(i).displayName;
+        // Twitch Emotes available globally
+        addEmotes(this->emoteTable_, sources.account->accessEmotes()->emotes,
+                  "Twitch Emote");
 
-        // test for match or match with colon at start for emotes like ":)"
-        if (emoteText.compare(text, Qt::CaseInsensitive) == 0 ||
-            emoteText.compare(":" + text, Qt::CaseInsensitive) == 0)
+        // Twitch Emotes available locally
+        auto localEmoteData = sources.account->accessLocalEmotes();
+        if (!sources.roomId.isEmpty())
         {
-            auto emote = emotes[i];
-            emotes.erase(emotes.begin() + int(i));
-            emotes.insert(emotes.begin(), emote);
-            break;
+            auto it = localEmoteData->find(sources.roomId);
+            if (it != localEmoteData->end())
+            {
+                addEmotes(this->emoteTable_, it->second,
+                          "Local Twitch Emotes");
+            }
         }
     }
 
+    // TODO extract "Channel {BetterTTV,7TV,FrankerFaceZ}" text into a #define.
+    static const QString providerNames[] = {
+        "Channel BetterTTV", "Channel FrankerFaceZ", "Channel 7TV",
+        "Global BetterTTV",  "Global FrankerFaceZ",  "Global 7TV",
+    };
+    for (size_t i = 0; i < sources.maps.size(); ++i)
+    {
+        if (sources.maps[i])
+        {
+            addEmotes(this->emoteTable_, *sources.maps[i], providerNames[i]);
+        }
+    }
+
+    addEmojis(this->emoteTable_, getApp()->emotes->emojis.emojis);
+
+    this->emoteSources_ = std::move(sources);
+}
+
+void InputCompletionPopup::updateEmotes(const QString &text, ChannelPtr channel)
+{
+    this->refreshEmoteTable(channel);
+
+    auto emotes = this->emoteTable_.query(text, MAX_ENTRY_COUNT);
+
     this->model_.clear();
 
-    int count = 0;
-    for (auto &&emote : emotes)
+    for (const auto *emote : emotes)
     {
         this->model_.addItem(std::make_unique<InputCompletionItem>(
-            emote.emote, emote.displayName + " - " + emote.providerName,
-            this->callback_));
-
-        if (count++ == MAX_ENTRY_COUNT)
-        {
-            break;
-        }
+            emote->emote, emote->displayName + " - " + emote->providerName,
+            [this, name = emote->displayName](const QString &value) {
+                this->emoteTable_.recordUsage(name);
+                if (this->callback_)
+                {
+                    this->callback_(value);
+                }
+            }));
     }
 
     if (!emotes.empty())
@@ -1,14 +1,18 @@
 #pragma once
 
 #include "common/Channel.hpp"
+#include "common/EmoteCompletionTable.hpp"
 #include "widgets/BasePopup.hpp"
 #include "widgets/listview/GenericListModel.hpp"
 
 #include <functional>
+#include <optional>
 
 namespace chatterino {
 
 class GenericListView;
+class EmoteMap;
+class TwitchAccount;
 
 class InputCompletionPopup : public BasePopup
 {
@@ -33,12 +37,30 @@ protected:
 private:
     void initLayout();
 
+    // Identifies the emotes that can be completed in a channel. The table is
+    // rebuilt when they change.
+    struct EmoteSources {
+        std::shared_ptr<TwitchAccount> account;
+        // See TwitchAccount::emoteGeneration
+        uint64_t emoteGeneration = 0;
+        // The room whose local (follower) emotes are in the table
+        QString roomId;
+        // Channel BTTV, FFZ and 7TV, then global BTTV, FFZ and 7TV
+        std::vector<std::shared_ptr<const EmoteMap>> maps;
+
+        bool operator==(const EmoteSources &other) const;
+    };
+
+    void refreshEmoteTable(const ChannelPtr &channel);
+
     struct {
         GenericListView *listView;
     } ui_;
 
     GenericListModel model_;
     ActionCallback callback_;
+    EmoteCompletionTable emoteTable_;
+    std::optional<EmoteSources> emoteSources_;
     QTimer redrawTimer_;
 };
 
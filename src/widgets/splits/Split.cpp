@@ -10,6 +10,7 @@
 #include "controllers/hotkeys/HotkeyController.hpp"
 #include "controllers/notifications/NotificationController.hpp"
 #include "messages/MessageThread.hpp"
+#include "providers/twitch/api/Helix.hpp"
 #include "providers/twitch/EmoteValue.hpp"
 #include "providers/twitch/TwitchAccount.hpp"
 #include "providers/twitch/TwitchChannel.hpp"
@@ -53,10 +54,15 @@
 #include <QMimeData>
 #include <QMovie>
 #include <QPainter>
+#include <QPointer>
 #include <QVBoxLayout>
 
+#include <algorithm>
 #include <functional>
+#include <iterator>
 #include <random>
+#include <unordered_set>
+#include <vector>
 
 namespace chatterino {
 namespace {
@@ -968,6 +974,9 @@ void Split::openWithCustomScheme()
 
 void Split::showViewerList()
 {
+    // Only used for moderators, who can page through the Helix chatter list
+    constexpr int MAX_VIEWER_LIST_CHATTERS = 50000;
+
     auto viewerDock =
         new QDockWidget("Viewer List - " + this->getChannel()->getName(), this);
     viewerDock->setAllowedAreas(Qt::LeftDockWidgetArea);
@@ -1017,7 +1026,9 @@ void Split::showViewerList()
         resultList->clear();
         for (auto &item : results)
         {
-            if (!item->text().contains("("))
+            // Group labels and spacers aren't chatters
+            if (!item->text().contains("(") &&
+                !item->data(Qt::UserRole).toBool())
             {
                 resultList->addItem(formatListItemText(item->text()));
             }
@@ -1028,43 +1039,252 @@ void Split::showViewerList()
     QObject::connect(searchBar, &QLineEdit::textEdited, this,
                      performListSearch);
 
-    NetworkRequest::twitchRequest("https://tmi.twitch.tv/group/user/" +
-                                  this->getChannel()->getName() + "/chatters")
-        .caller(this)
-        .onSuccess([=, this](auto result) -> Outcome {
-            auto obj = result.parseJson();
-            QJsonObject chattersObj = obj.value("chatters").toObject();
+    auto *twitchChannel =
+        dynamic_cast<TwitchChannel *>(this->getChannel().get());
+    if (twitchChannel != nullptr && twitchChannel->hasModRights())
+    {
+        // Mods can use the paginated Helix endpoint, so fill the list page by
+        // page instead of waiting for every chatter. Helix doesn't tell us
+        // the roles of chatters, only the broadcaster can list the moderators
+        // and VIPs, so everyone else only sees the broadcaster separately.
+        struct Group {
+            QString name;
+            QListWidgetItem *label;
+            QListWidgetItem *spacer;
+            // Sorted, in the same order as the group's rows
+            std::vector<QString> chatters;
+        };
+        struct ViewerList {
+            // Broadcaster, moderators, VIPs and viewers, in list order
+            std::vector<Group> groups;
+            std::unordered_set<QString> moderators;
+            std::unordered_set<QString> vips;
+        };
+        auto list = std::make_shared<ViewerList>();
+        // Items without their own font use the list's font
+        chattersList->setFont(
+            getApp()->fonts->getFont(FontStyle::ChatMedium, 1.0));
+        for (int i : {0, 1, 2, 6})
+        {
+            Group group{labels.at(i), formatListItemText(labels.at(i)),
+                        new QListWidgetItem()};
+            group.label->setForeground(this->theme->accent);
+            group.label->setData(Qt::UserRole, true);
+            group.spacer->setData(Qt::UserRole, true);
+            chattersList->addItem(group.label);
+            chattersList->addItem(group.spacer);
+            group.label->setHidden(true);
+            group.spacer->setHidden(true);
+            list->groups.push_back(group);
+        }
 
-            viewerDock->setWindowTitle(
-                QString("Viewer List - %1 (%2 chatters)")
-                    .arg(this->getChannel()->getName())
-                    .arg(localizeNumbers(obj.value("chatter_count").toInt())));
+        auto groupOf = [list, broadcaster = twitchChannel->getName()](
+                           const QString &chatter) -> size_t {
+            if (chatter == broadcaster)
+            {
+                return 0;
+            }
+            if (list->moderators.count(chatter) != 0)
+            {
+                return 1;
+            }
+            if (list->vips.count(chatter) != 0)
+            {
+                return 2;
+            }
+            return 3;
+        };
+
+        // Sorts a page of chatters into their groups and merges each group in
+        // one batch: the new rows are inserted at the end of the group at
+        // once, and only the rows from the first new chatter on are renamed.
+        auto addChatters = [=](const std::unordered_set<QString> &chatters) {
+            std::vector<std::vector<QString>> added(list->groups.size());
+            for (const auto &chatter : chatters)
+            {
+                added[groupOf(chatter)].push_back(chatter);
+            }
 
-            loadingLabel->hide();
-            for (int i = 0; i < jsonLabels.size(); i++)
+            // Row of the current group's label
+            int start = 0;
+            for (size_t i = 0; i < list->groups.size(); i++)
             {
-                auto currentCategory =
-                    chattersObj.value(jsonLabels.at(i)).toArray();
-                // If current category of chatters is empty, dont show this
-                // category.
-                if (currentCategory.empty())
-                    continue;
-
-                auto label = formatListItemText(QString("%1 (%2)").arg(
-                    labels.at(i), localizeNumbers(currentCategory.size())));
-                label->setForeground(this->theme->accent);
-                chattersList->addItem(label);
-                foreach (const QJsonValue &v, currentCategory)
+                auto &group = list->groups[i];
+                auto &newChatters = added[i];
+                if (!newChatters.empty())
                 {
-                    chattersList->addItem(formatListItemText(v.toString()));
+                    std::sort(newChatters.begin(), newChatters.end());
+
+                    std::vector<QString> merged;
+                    merged.reserve(group.chatters.size() + newChatters.size());
+                    std::merge(group.chatters.begin(), group.chatters.end(),
+                               newChatters.begin(), newChatters.end(),
+                               std::back_inserter(merged));
+                    // Pages can overlap while chatters join and leave
+                    merged.erase(std::unique(merged.begin(), merged.end()),
+                                 merged.end());
+
+                    auto oldSize = int(group.chatters.size());
+                    auto changed =
+                        int(std::mismatch(group.chatters.begin(),
+                                          group.chatters.end(), merged.begin())
+                                .first -
+                            group.chatters.begin());
+
+                    QStringList appended;
+                    for (auto j = size_t(oldSize); j < merged.size(); j++)
+                    {
+                        appended.append(merged[j]);
+                    }
+                    if (!appended.isEmpty())
+                    {
+                        chattersList->insertItems(start + 1 + oldSize,
+                                                  appended);
+                    }
+                    for (int j = changed; j < oldSize; j++)
+                    {
+                        chattersList->item(start + 1 + j)->setText(merged[j]);
+                    }
+
+                    group.chatters = std::move(merged);
+                    group.label->setText(QString("%1 (%2)").arg(
+                        group.name,
+                        localizeNumbers(int(group.chatters.size()))));
+                    group.label->setHidden(false);
+                    group.spacer->setHidden(false);
                 }
-                chattersList->addItem(new QListWidgetItem());
+
+                start += int(group.chatters.size()) + 2;
             }
+        };
+
+        QPointer<QDockWidget> dockGuard(viewerDock);
+        auto channelId = twitchChannel->roomId();
+
+        auto loadChatters = [=, this]() {
+            getHelix()->getChattersPaged(
+                channelId, getApp()->accounts->twitch.getCurrent()->getUserId(),
+                MAX_VIEWER_LIST_CHATTERS,
+                [=, this](const HelixChatters &chatters) {
+                    if (!dockGuard || !dockGuard->isVisible())
+                    {
+                        // The viewer list was closed, stop paginating
+                        return false;
+                    }
+
+                    loadingLabel->hide();
+                    viewerDock->setWindowTitle(
+                        QString("Viewer List - %1 (%2 chatters)")
+                            .arg(this->getChannel()->getName())
+                            .arg(localizeNumbers(chatters.total)));
+
+                    addChatters(chatters.chatters);
+
+                    // Only the new chatters are added to the search results
+                    auto query = searchBar->text();
+                    if (!query.isEmpty())
+                    {
+                        for (const auto &chatter : chatters.chatters)
+                        {
+                            if (chatter.contains(query, Qt::CaseInsensitive))
+                            {
+                                resultList->addItem(
+                                    formatListItemText(chatter));
+                            }
+                        }
+                    }
+
+                    return true;
+                },
+                [](bool /*complete*/) {},
+                [=](auto /*error*/, auto message) {
+                    if (dockGuard)
+                    {
+                        loadingLabel->setText("Failed to load chatters: " +
+                                              message);
+                        loadingLabel->show();
+                    }
+                });
+        };
+
+        if (twitchChannel->isBroadcaster())
+        {
+            // The roles are needed to group the chatters, so they're loaded
+            // first. The list still fills if either of them fails.
+            getHelix()->getModerators(
+                channelId, 500,
+                [=](const auto &moderators) {
+                    for (const auto &moderator : moderators)
+                    {
+                        list->moderators.insert(moderator.userLogin);
+                    }
+                    getHelix()->getChannelVIPs(
+                        channelId,
+                        [=](const auto &vips) {
+                            for (const auto &vip : vips)
+                            {
+                                list->vips.insert(vip.userLogin);
+                            }
+                            loadChatters();
+                        },
+                        [=](auto /*error*/, auto /*message*/) {
+                            loadChatters();
+                        });
+                },
+                [=](auto /*error*/, auto /*message*/) {
+                    loadChatters();
+                });
+        }
+        else
+        {
+            loadChatters();
+        }
+    }
+    else
+    {
+        NetworkRequest::twitchRequest("https://tmi.twitch.tv/group/user/" +
+                                      this->getChannel()->getName() +
+                                      "/chatters")
+            .caller(this)
+            .onSuccess([=, this](auto result) -> Outcome {
+                auto obj = result.parseJson();
+                QJsonObject chattersObj = obj.value("chatters").toObject();
+
+                viewerDock->setWindowTitle(
+                    QString("Viewer List - %1 (%2 chatters)")
+                        .arg(this->getChannel()->getName())
+                        .arg(localizeNumbers(
+                            obj.value("chatter_count").toInt())));
+
+                loadingLabel->hide();
+                for (int i = 0; i < jsonLabels.size(); i++)
+                {
+                    auto currentCategory =
+                        chattersObj.value(jsonLabels.at(i)).toArray();
+                    // If current category of chatters is empty, dont show this
+                    // category.
+                    if (currentCategory.empty())
+                        continue;
+
+                    auto label = formatListItemText(
+                        QString("%1 (%2)").arg(
+                            labels.at(i),
+                            localizeNumbers(currentCategory.size())));
+                    label->setForeground(this->theme->accent);
+                    chattersList->addItem(label);
+                    foreach (const QJsonValue &v, currentCategory)
+                    {
+                        chattersList->addItem(
+                            formatListItemText(v.toString()));
+                    }
+                    chattersList->addItem(new QListWidgetItem());
+                }
 
-            performListSearch();
-            return Success;
-        })
-        .execute();
+                performListSearch();
+                return Success;
+            })
+            .execute();
+    }
 
     QObject::connect(viewerDock, &QDockWidget::topLevelChanged, this, [=]() {
         viewerDock->setMinimumWidth(300);
@@ -1187,6 +1407,8 @@ void Split::showSearch(bool singleChannel)
     for (int i = 0; i < notebook.getPageCount(); ++i)
     {
         auto container = dynamic_cast<SplitContainer *>(notebook.getPageAt(i));
+        // Tabs that weren't shown yet are searched as well
+        container->createPendingSplits();
         for (auto split : container->getSplits())
         {
             popup->addChannel(split->getChannelView());
@@ -4,7 +4,10 @@
 #include "common/Common.hpp"
 #include "common/QLogging.hpp"
 #include "debug/AssertInGuiThread.hpp"
+#include "messages/Message.hpp"
+#include "providers/twitch/TwitchChannel.hpp"
 #include "singletons/Fonts.hpp"
+#include "singletons/Settings.hpp"
 #include "singletons/Theme.hpp"
 #include "singletons/WindowManager.hpp"
 #include "widgets/helper/ChannelView.hpp"
@@ -17,14 +20,32 @@
 
 #include <boost/foreach.hpp>
 #include <QApplication>
-#include <QJsonArray>
-#include <QJsonObject>
 #include <QMimeData>
 #include <QPainter>
 
 #include <algorithm>
 
 namespace chatterino {
+namespace {
+
+    void collectSplitDescriptors(const NodeDescriptor &node,
+                                 std::vector<const SplitDescriptor *> &out)
+    {
+        if (const auto *split = std::get_if<SplitNodeDescriptor>(&node))
+        {
+            out.push_back(split);
+        }
+        else if (const auto *container =
+                     std::get_if<ContainerNodeDescriptor>(&node))
+        {
+            for (const auto &item : container->items_)
+            {
+                collectSplitDescriptors(item, out);
+            }
+        }
+    }
+
+}  // namespace
 
 SplitContainer::SplitContainer(Notebook *parent)
     : BaseWidget(parent)
@@ -577,6 +598,13 @@ void SplitContainer::resizeEvent(QResizeEvent *event)
     this->layout();
 }
 
+void SplitContainer::showEvent(QShowEvent *event)
+{
+    BaseWidget::showEvent(event);
+
+    this->createPendingSplits();
+}
+
 void SplitContainer::mouseReleaseEvent(QMouseEvent *event)
 {
     if (event->button() == Qt::LeftButton)
@@ -773,14 +801,94 @@ void SplitContainer::applyFromDescriptor(const NodeDescriptor &rootNode)
     this->layout();
 }
 
+void SplitContainer::setPendingDescriptor(const NodeDescriptor &rootNode)
+{
+    assert(this->baseNode_.type_ == Node::Type::EmptyRoot);
+
+    this->pendingDescriptor_ = rootNode;
+    this->pendingChannels_.clear();
+    this->pendingConnections_ =
+        std::make_unique<pajlada::Signals::SignalHolder>();
+
+    std::vector<const SplitDescriptor *> splits;
+    collectSplitDescriptors(rootNode, splits);
+
+    for (const auto *split : splits)
+    {
+        auto channel = WindowManager::decodeChannel(*split).get();
+        this->pendingChannels_.push_back(channel);
+
+        // Same as ChannelView::messageAppended
+        this->pendingConnections_->managedConnect(
+            channel->messageAppended,
+            [this, type = channel->getType()](
+                MessagePtr &message, boost::optional<MessageFlags> flags) {
+                if (this->tab_ == nullptr)
+                {
+                    return;
+                }
+
+                const auto &messageFlags = flags ? *flags : message->flags;
+                if (messageFlags.has(MessageFlag::DoNotTriggerNotification))
+                {
+                    return;
+                }
+
+                if (messageFlags.has(MessageFlag::Highlighted) &&
+                    messageFlags.has(MessageFlag::ShowInMentions) &&
+                    !messageFlags.has(MessageFlag::Subscription) &&
+                    (getSettings()->highlightMentions ||
+                     type != Channel::Type::TwitchMentions))
+                {
+                    this->tab_->setHighlightState(HighlightState::Highlighted);
+                }
+                else
+                {
+                    this->tab_->setHighlightState(HighlightState::NewMessage);
+                }
+            });
+
+        if (auto *tc = dynamic_cast<TwitchChannel *>(channel.get()))
+        {
+            this->pendingConnections_->managedConnect(
+                tc->liveStatusChanged, [this]() {
+                    this->refreshTabLiveStatus();
+                });
+        }
+    }
+
+    this->refreshTab();
+}
+
+const std::optional<NodeDescriptor> &SplitContainer::getPendingDescriptor()
+    const
+{
+    return this->pendingDescriptor_;
+}
+
+void SplitContainer::createPendingSplits()
+{
+    if (!this->pendingDescriptor_)
+    {
+        return;
+    }
+
+    auto rootNode = std::move(*this->pendingDescriptor_);
+    this->pendingDescriptor_.reset();
+    this->pendingConnections_.reset();
+
+    this->applyFromDescriptor(rootNode);
+
+    // The splits hold on to the channels now
+    this->pendingChannels_.clear();
+}
+
 void SplitContainer::popup()
 {
     Window &window = getApp()->windows->createWindow(WindowType::Popup);
     auto *popupContainer = window.getNotebook().getOrAddSelectedPage();
 
-    QJsonObject encodedTab;
-    WindowManager::encodeTab(this, true, encodedTab);
-    TabDescriptor tab = TabDescriptor::loadFromJSON(encodedTab);
+    TabDescriptor tab = WindowManager::describeTab(this, true);
 
     // custom title
     if (!tab.customTitle_.isEmpty())
@@ -893,9 +1001,9 @@ void SplitContainer::refreshTabTitle()
     QString newTitle = "";
     bool first = true;
 
-    for (const auto &chatWidget : this->splits_)
+    for (const auto &channel : this->getChannels())
     {
-        auto channelName = chatWidget->getChannel()->getLocalizedName();
+        auto channelName = channel->getLocalizedName();
         if (channelName.isEmpty())
         {
             continue;
@@ -926,9 +1034,8 @@ void SplitContainer::refreshTabLiveStatus()
     }
 
     bool liveStatus = false;
-    for (const auto &s : this->splits_)
+    for (const auto &c : this->getChannels())
     {
-        auto c = s->getChannel();
         if (c->isLive())
         {
             liveStatus = true;
@@ -939,6 +1046,16 @@ void SplitContainer::refreshTabLiveStatus()
     this->tab_->setLive(liveStatus);
 }
 
+std::vector<ChannelPtr> SplitContainer::getChannels() const
+{
+    auto channels = this->pendingChannels_;
+    for (auto *split : this->splits_)
+    {
+        channels.push_back(split->getChannel());
+    }
+    return channels;
+}
+
 //
 // Node
 //
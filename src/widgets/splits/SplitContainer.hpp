@@ -10,6 +10,7 @@
 #include <QWidget>
 
 #include <algorithm>
+#include <memory>
 #include <optional>
 #include <unordered_map>
 #include <vector>
@@ -18,6 +19,7 @@ class QJsonObject;
 
 namespace chatterino {
 
+class Channel;
 class Split;
 class NotebookTab;
 class Notebook;
@@ -224,6 +226,19 @@ public:
 
     void applyFromDescriptor(const NodeDescriptor &rootNode);
 
+    // Keeps `rootNode` until the container is shown for the first time and
+    // only creates its splits then. The channels of the splits are joined
+    // right away, so the tab is still highlighted for new messages.
+    void setPendingDescriptor(const NodeDescriptor &rootNode);
+    const std::optional<NodeDescriptor> &getPendingDescriptor() const;
+    // Creates the splits of the pending descriptor now. getSplits() doesn't
+    // return them until this is called or the container is shown.
+    void createPendingSplits();
+
+    // Channels of the splits, or of the pending descriptor if the splits
+    // weren't created yet
+    std::vector<std::shared_ptr<Channel>> getChannels() const;
+
     void popup();
 
 protected:
@@ -237,6 +252,7 @@ protected:
     void dragEnterEvent(QDragEnterEvent *event) override;
 
     void resizeEvent(QResizeEvent *event) override;
+    void showEvent(QShowEvent *event) override;
 
 private:
     void applyFromDescriptorRecursively(const NodeDescriptor &rootNode,
@@ -270,6 +286,11 @@ private:
     std::unordered_map<Split *, pajlada::Signals::SignalHolder>
         connectionsPerSplit_;
 
+    std::optional<NodeDescriptor> pendingDescriptor_;
+    // Keeps the channels of the pending descriptor joined
+    std::vector<std::shared_ptr<Channel>> pendingChannels_;
+    std::unique_ptr<pajlada::Signals::SignalHolder> pendingConnections_;
+
     pajlada::Signals::SignalHolder signalHolder_;
 
     // Specifies whether the user is currently dragging something over this container
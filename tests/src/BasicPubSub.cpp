@@ -146,3 +146,43 @@ TEST(BasicPubSub, SubscriptionCycle)
     ASSERT_EQ(manager->diag.connectionsFailed, 0);
     ASSERT_EQ(manager->messagesReceived, 2);
 }
+
+TEST(BasicPubSub, SharedTransport)
+{
+    const QString host("wss://127.0.0.1:9050/liveupdates/sub-unsub");
+    auto *first = new MyManager(host);
+    auto *second = new MyManager(host);
+    first->start();
+    second->start();
+
+    std::this_thread::sleep_for(50ms);
+    first->sub({1, "foo"});
+    second->sub({2, "bar"});
+    std::this_thread::sleep_for(500ms);
+
+    ASSERT_EQ(first->diag.connectionsOpened, 1);
+    ASSERT_EQ(second->diag.connectionsOpened, 1);
+    ASSERT_EQ(first->messagesReceived, 1);
+    ASSERT_EQ(second->messagesReceived, 1);
+
+    ASSERT_EQ(first->popMessage(), QString("ack-sub-1-foo"));
+    ASSERT_EQ(second->popMessage(), QString("ack-sub-2-bar"));
+
+    // Stopping one manager must not affect the other one's connection
+    first->stop();
+
+    ASSERT_EQ(first->diag.connectionsClosed, 1);
+    ASSERT_EQ(second->diag.connectionsClosed, 0);
+
+    second->unsub({2, "bar"});
+    std::this_thread::sleep_for(50ms);
+
+    ASSERT_EQ(second->messagesReceived, 2);
+    ASSERT_EQ(second->popMessage(), QString("ack-unsub-2-bar"));
+
+    second->stop();
+
+    ASSERT_EQ(second->diag.connectionsOpened, 1);
+    ASSERT_EQ(second->diag.connectionsClosed, 1);
+    ASSERT_EQ(second->diag.connectionsFailed, 0);
+}
@@ -0,0 +1,85 @@
+#include "widgets/helper/ChannelViewRegistry.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace chatterino;
+
+namespace {
+
+struct FakeView {
+    int layouts = 0;
+
+    void queueLayout()
+    {
+        this->layouts++;
+    }
+};
+
+// Only the addresses of channels are used
+const Channel *channel(int i)
+{
+    static char channels[4];
+    return reinterpret_cast<const Channel *>(&channels[i]);
+}
+
+}  // namespace
+
+TEST(ChannelViewRegistry, ChannelRequest)
+{
+    ChannelViewRegistry<FakeView> registry;
+    FakeView a, b;
+    registry.add(&a);
+    registry.add(&b);
+    registry.setChannel(&a, channel(0));
+    registry.setChannel(&b, channel(1));
+    registry.setVisible(&a, true);
+    registry.setVisible(&b, true);
+
+    registry.requestLayout(channel(0));
+    EXPECT_EQ(a.layouts, 1);
+    EXPECT_EQ(b.layouts, 0);
+
+    registry.setChannel(&a, channel(1));
+    registry.requestLayout(channel(1));
+    EXPECT_EQ(a.layouts, 2);
+    EXPECT_EQ(b.layouts, 1);
+    EXPECT_EQ(registry.viewCount(channel(0)), 0);
+    EXPECT_EQ(registry.viewCount(channel(1)), 2);
+
+    registry.remove(&a);
+    registry.requestLayout(channel(1));
+    EXPECT_EQ(a.layouts, 2);
+    EXPECT_EQ(b.layouts, 2);
+}
+
+TEST(ChannelViewRegistry, DeferredUntilShown)
+{
+    ChannelViewRegistry<FakeView> registry;
+    FakeView view;
+    registry.add(&view);
+    registry.setChannel(&view, channel(0));
+
+    EXPECT_FALSE(registry.setVisible(&view, true));
+    EXPECT_FALSE(registry.setVisible(&view, false));
+
+    // Requests for other channels don't concern the view
+    registry.requestLayout(channel(1));
+    EXPECT_FALSE(registry.setVisible(&view, true));
+    registry.setVisible(&view, false);
+
+    registry.requestLayout(channel(0));
+    EXPECT_EQ(view.layouts, 0);
+    EXPECT_TRUE(registry.setVisible(&view, true));
+    registry.setVisible(&view, false);
+
+    registry.requestLayout(nullptr);
+    EXPECT_EQ(view.layouts, 0);
+    EXPECT_TRUE(registry.setVisible(&view, true));
+
+    // Only reported once
+    registry.setVisible(&view, false);
+    EXPECT_FALSE(registry.setVisible(&view, true));
+
+    registry.requestLayout(nullptr);
+    EXPECT_EQ(view.layouts, 1);
+}
@@ -82,3 +82,119 @@ TEST(ChatterSet, MaxSizeLastUsed)
     EXPECT_TRUE(set.contains("pajlada"));
     EXPECT_TRUE(set.contains("Pajlada"));
 }
+
+TEST(ChatterSet, FilterByPrefix)
+{
+    chatterino::ChatterSet set;
+
+    set.addRecentChatter("pajlada");
+    set.addRecentChatter("Pajbot");
+    set.addRecentChatter("forsen");
+    set.addRecentChatter("PAJAWESOME");
+
+    // Most recent chatters come first
+    EXPECT_EQ(set.filterByPrefix("paj"),
+              (std::vector<QString>{"PAJAWESOME", "Pajbot", "pajlada"}));
+    EXPECT_EQ(set.filterByPrefix("PAJL"), (std::vector<QString>{"pajlada"}));
+    EXPECT_EQ(set.filterByPrefix("for"), (std::vector<QString>{"forsen"}));
+    EXPECT_TRUE(set.filterByPrefix("x").empty());
+    EXPECT_EQ(set.filterByPrefix("").size(), 4);
+
+    // Bumping a chatter moves it to the front
+    set.addRecentChatter("pajlada");
+    EXPECT_EQ(set.filterByPrefix("paj"),
+              (std::vector<QString>{"pajlada", "PAJAWESOME", "Pajbot"}));
+
+    // Evicted chatters don't show up anymore
+    for (size_t i = 0; i < chatterino::ChatterSet::chatterLimit; ++i)
+    {
+        set.addRecentChatter(QString("user%1").arg(i));
+    }
+    EXPECT_TRUE(set.filterByPrefix("paj").empty());
+    EXPECT_EQ(set.size(), chatterino::ChatterSet::chatterLimit);
+}
+
+TEST(ChatterSet, UpdateOnlineChatters)
+{
+    chatterino::ChatterSet set;
+
+    set.addRecentChatter("Pajlada");
+    set.addRecentChatter("forsen");
+
+    set.updateOnlineChatters({"pajlada", "zneix", "mm2pl"});
+
+    // forsen went offline
+    EXPECT_FALSE(set.contains("forsen"));
+    EXPECT_TRUE(set.contains("zneix"));
+    EXPECT_TRUE(set.contains("MM2PL"));
+
+    // The casing of pajlada is kept, and chatters that wrote a message come
+    // before the ones that only showed up in the chatter list
+    EXPECT_EQ(set.filterByPrefix("")[0], "Pajlada");
+    EXPECT_EQ(set.size(), 3);
+
+    // Too many online chatters => only keep the ones we already know
+    std::unordered_set<QString> manyChatters{"pajlada"};
+    for (size_t i = 0; i < chatterino::ChatterSet::chatterLimit; ++i)
+    {
+        manyChatters.insert(QString("user%1").arg(i));
+    }
+    set.updateOnlineChatters(manyChatters);
+
+    EXPECT_TRUE(set.contains("pajlada"));
+    EXPECT_FALSE(set.contains("zneix"));
+    EXPECT_FALSE(set.contains("user1"));
+    EXPECT_EQ(set.size(), 1);
+}
+
+TEST(ChatterSet, PaginatedOnlineChattersUpdate)
+{
+    chatterino::ChatterSet set;
+
+    set.addRecentChatter("Pajlada");
+    set.addRecentChatter("forsen");
+    set.addRecentChatter("zneix");
+
+    set.beginOnlineChattersUpdate();
+
+    set.addOnlineChatters({"pajlada", "mm2pl"});
+    // Chatters are available as soon as their page arrived
+    EXPECT_TRUE(set.contains("mm2pl"));
+    // Nothing is removed until the update is finished
+    EXPECT_TRUE(set.contains("forsen"));
+
+    // Chatting during an update counts as being online
+    set.addRecentChatter("zneix");
+
+    set.addOnlineChatters({"nerixyz"});
+    set.finishOnlineChattersUpdate();
+
+    EXPECT_TRUE(set.contains("pajlada"));
+    EXPECT_TRUE(set.contains("mm2pl"));
+    EXPECT_TRUE(set.contains("nerixyz"));
+    EXPECT_TRUE(set.contains("zneix"));
+    EXPECT_FALSE(set.contains("forsen"));
+    EXPECT_EQ(set.size(), 4);
+
+    // The casing of chatters is kept
+    EXPECT_EQ(set.filterByPrefix("paj"), (std::vector<QString>{"Pajlada"}));
+}
+
+TEST(ChatterSet, PaginatedOnlineChattersUpdateLimit)
+{
+    chatterino::ChatterSet set;
+
+    set.addRecentChatter("pajlada");
+
+    set.beginOnlineChattersUpdate();
+    for (size_t i = 0; i < chatterino::ChatterSet::chatterLimit; ++i)
+    {
+        set.addOnlineChatters({QString("user%1").arg(i)});
+    }
+    set.addOnlineChatters({"pajlada"});
+    set.finishOnlineChattersUpdate();
+
+    // Online chatters never push out chatters that wrote a message
+    EXPECT_TRUE(set.contains("pajlada"));
+    EXPECT_EQ(set.size(), chatterino::ChatterSet::chatterLimit);
+}
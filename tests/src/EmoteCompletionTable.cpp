@@ -0,0 +1,95 @@
+#include "common/EmoteCompletionTable.hpp"
+
+#include <gtest/gtest.h>
+#include <QStringList>
+
+using namespace chatterino;
+
+namespace {
+
+QStringList query(const EmoteCompletionTable &table, const QString &text,
+                  size_t limit = 10)
+{
+    QStringList names;
+    for (const auto *candidate : table.query(text, limit))
+    {
+        names.append(candidate->displayName);
+    }
+    return names;
+}
+
+}  // namespace
+
+TEST(EmoteCompletionTable, MatchKinds)
+{
+    EmoteCompletionTable table;
+    table.add(nullptr, "pepeKEKW", "");
+    table.add(nullptr, "xkekwx", "");
+    table.add(nullptr, "KEKWait", "");
+    table.add(nullptr, "KEKW", "");
+    table.add(nullptr, "KappaKeepo", "");
+    table.add(nullptr, "Kappa", "");
+
+    // exact, prefix, start of a word, substring
+    EXPECT_EQ(query(table, "kekw"),
+              QStringList({"KEKW", "KEKWait", "pepeKEKW", "xkekwx"}));
+
+    // Subsequences rank below substrings
+    EXPECT_EQ(query(table, "kpk"), QStringList({"KappaKeepo"}));
+    EXPECT_EQ(query(table, "kap"), QStringList({"Kappa", "KappaKeepo"}));
+
+    EXPECT_TRUE(query(table, "kekwz").isEmpty());
+}
+
+TEST(EmoteCompletionTable, ExactMatchWithColon)
+{
+    EmoteCompletionTable table;
+    table.add(nullptr, ":)))", "");
+    table.add(nullptr, ":)", "");
+
+    EXPECT_EQ(query(table, ")"), QStringList({":)", ":)))"}));
+}
+
+TEST(EmoteCompletionTable, InsertionOrderBreaksTies)
+{
+    EmoteCompletionTable table;
+    table.add(nullptr, "LUL", "Twitch");
+    table.add(nullptr, "LUL", "BetterTTV");
+
+    auto result = table.query("lul", 10);
+    ASSERT_EQ(result.size(), 2);
+    EXPECT_EQ(result[0]->providerName, "Twitch");
+    EXPECT_EQ(result[1]->providerName, "BetterTTV");
+}
+
+TEST(EmoteCompletionTable, RecentUsage)
+{
+    EmoteCompletionTable table;
+    table.add(nullptr, "catJAM", "");
+    table.add(nullptr, "catKISS", "");
+
+    EXPECT_EQ(query(table, "cat"), QStringList({"catJAM", "catKISS"}));
+
+    table.recordUsage("catkiss");
+    EXPECT_EQ(query(table, "cat"), QStringList({"catKISS", "catJAM"}));
+
+    // The usage survives rebuilding the table
+    table.clear();
+    table.add(nullptr, "catJAM", "");
+    table.add(nullptr, "catKISS", "");
+    EXPECT_EQ(query(table, "cat"), QStringList({"catKISS", "catJAM"}));
+}
+
+TEST(EmoteCompletionTable, Limit)
+{
+    EmoteCompletionTable table;
+    for (int i = 0; i < 100; ++i)
+    {
+        table.add(nullptr, QString("emote%1").arg(i), "");
+    }
+
+    auto result = table.query("emote", 5);
+    ASSERT_EQ(result.size(), 5);
+    EXPECT_EQ(result[0]->displayName, "emote0");
+    EXPECT_EQ(result[4]->displayName, "emote4");
+}
@@ -380,6 +380,16 @@ public:
          (FailureCallback<HelixGetChattersError, QString> failureCallback)),
         (override));  // getChatters
 
+    // getChattersPaged
+    // The extra parenthesis around the failure callback is because its type contains a comma
+    MOCK_METHOD(
+        void, getChattersPaged,
+        (QString broadcasterID, QString moderatorID, int maxChattersToFetch,
+         std::function<bool(const HelixChatters &)> pageCallback,
+         ResultCallback<bool> finishedCallback,
+         (FailureCallback<HelixGetChattersError, QString> failureCallback)),
+        (override));  // getChattersPaged
+
     // /vips
     // The extra parenthesis around the failure callback is because its type contains a comma
     MOCK_METHOD(
@@ -112,6 +112,25 @@ TEST(LimitedQueue, PushFront)
     EXPECT_EQ(pushed2.size(), 0);
 }
 
+TEST(LimitedQueue, PopFront)
+{
+    LimitedQueue<int> queue(5);
+    int popped = 0;
+
+    EXPECT_FALSE(queue.popFront(popped));
+
+    queue.pushBack(1);
+    queue.pushBack(2);
+
+    EXPECT_TRUE(queue.popFront(popped));
+    EXPECT_EQ(popped, 1);
+    SNAPSHOT_EQUALS(queue.getSnapshot(), {2}, "after pop");
+
+    EXPECT_TRUE(queue.popFront(popped));
+    EXPECT_EQ(popped, 2);
+    EXPECT_TRUE(queue.empty());
+}
+
 TEST(LimitedQueue, ReplaceItem)
 {
     LimitedQueue<int> queue(5);
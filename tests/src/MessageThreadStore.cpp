@@ -0,0 +1,221 @@
+#include "messages/MessageThreadStore.hpp"
+
+#include "common/Channel.hpp"
+#include "messages/Message.hpp"
+#include "messages/MessageThread.hpp"
+
+#include <gtest/gtest.h>
+
+#include <deque>
+#include <memory>
+
+using namespace chatterino;
+
+namespace {
+
+std::shared_ptr<Message> makeMessage(const QString &id)
+{
+    auto message = std::make_shared<Message>();
+    message->id = id;
+    return message;
+}
+
+}  // namespace
+
+TEST(MessageThreadStore, FindMessage)
+{
+    MessageThreadStore store(Channel::DEFAULT_MESSAGE_LIMIT);
+
+    auto message = makeMessage("abc");
+    store.addMessage(message);
+
+    EXPECT_EQ(store.findMessage("abc"), message);
+    EXPECT_EQ(store.findMessage("def"), nullptr);
+
+    store.removeMessage(message);
+    EXPECT_EQ(store.findMessage("abc"), nullptr);
+    EXPECT_EQ(store.messageCount(), 0);
+}
+
+TEST(MessageThreadStore, ExpiredMessage)
+{
+    MessageThreadStore store(Channel::DEFAULT_MESSAGE_LIMIT);
+
+    store.addMessage(makeMessage("abc"));
+
+    // The store doesn't keep messages alive
+    EXPECT_EQ(store.findMessage("abc"), nullptr);
+}
+
+TEST(MessageThreadStore, EvictsOldestMessage)
+{
+    MessageThreadStore store(2);
+
+    auto first = makeMessage("1");
+    auto second = makeMessage("2");
+    auto third = makeMessage("3");
+    store.addMessage(first);
+    store.addMessage(second);
+    store.addMessage(third);
+
+    EXPECT_EQ(store.messageCount(), 2);
+    EXPECT_EQ(store.findMessage("1"), nullptr);
+    EXPECT_EQ(store.findMessage("2"), second);
+    EXPECT_EQ(store.findMessage("3"), third);
+}
+
+TEST(MessageThreadStore, ReAddedMessage)
+{
+    MessageThreadStore store(2);
+
+    auto first = makeMessage("1");
+    auto second = makeMessage("2");
+    store.addMessage(first);
+    store.removeMessage(first);
+    store.addMessage(second);
+    store.addMessage(first);
+
+    // The stale position of "1" must not evict the re-added entry
+    auto third = makeMessage("3");
+    store.addMessage(third);
+
+    EXPECT_EQ(store.findMessage("1"), first);
+    EXPECT_EQ(store.findMessage("2"), nullptr);
+    EXPECT_EQ(store.findMessage("3"), third);
+}
+
+TEST(MessageThreadStore, ThreadRemovedWithLastReply)
+{
+    MessageThreadStore store(Channel::DEFAULT_MESSAGE_LIMIT);
+
+    auto root = makeMessage("root");
+    auto thread = std::make_shared<MessageThread>(root);
+    store.addThread(thread);
+
+    auto reply = makeMessage("reply");
+    reply->replyThread = thread;
+    thread->addToThread(std::weak_ptr<const Message>(reply));
+    store.addMessage(reply);
+
+    EXPECT_EQ(store.getThread("root"), thread);
+
+    store.removeMessage(reply);
+    EXPECT_EQ(store.getThread("root"), nullptr);
+    EXPECT_EQ(store.threadCount(), 0);
+}
+
+TEST(MessageThreadStore, CleanUpThreads)
+{
+    MessageThreadStore store(Channel::DEFAULT_MESSAGE_LIMIT);
+
+    auto root = makeMessage("root");
+    auto thread = std::make_shared<MessageThread>(root);
+    store.addThread(thread);
+
+    store.cleanUpThreads();
+    EXPECT_EQ(store.threadCount(), 0);
+}
+
+TEST(MessageThreadStore, KeepsThreadsWithLiveReplies)
+{
+    MessageThreadStore store(1);
+
+    auto liveRoot = makeMessage("live");
+    auto liveThread = std::make_shared<MessageThread>(liveRoot);
+    store.addThread(liveThread);
+
+    auto reply = makeMessage("reply");
+    reply->replyThread = liveThread;
+    liveThread->addToThread(std::weak_ptr<const Message>(reply));
+
+    auto otherRoot = makeMessage("other");
+    auto otherThread = std::make_shared<MessageThread>(otherRoot);
+    store.addThread(otherThread);
+
+    // The live thread stays findable, so replies don't fork it
+    EXPECT_EQ(store.getThread("live"), liveThread);
+    EXPECT_EQ(store.getThread("other"), otherThread);
+
+    // Once its replies are gone, it's evicted like any other thread
+    reply.reset();
+    auto lastRoot = makeMessage("last");
+    auto lastThread = std::make_shared<MessageThread>(lastRoot);
+    store.addThread(lastThread);
+
+    EXPECT_EQ(store.getThread("live"), nullptr);
+    EXPECT_EQ(store.getThread("last"), lastThread);
+}
+
+TEST(MessageThreadStore, HundredThousandReplies)
+{
+    constexpr size_t limit = 1000;
+    constexpr size_t replyCount = 100000;
+    constexpr size_t repliesPerThread = 10;
+
+    MessageThreadStore store(limit);
+
+    // Simulates the channel's message buffer
+    std::deque<MessagePtr> buffer;
+    auto push = [&](const MessagePtr &message) {
+        buffer.push_back(message);
+        store.addMessage(message);
+        if (buffer.size() > limit)
+        {
+            store.removeMessage(buffer.front());
+            buffer.pop_front();
+        }
+    };
+
+    // One thread that keeps receiving replies
+    auto longRoot = makeMessage("long-root");
+    push(longRoot);
+    auto longThread = std::make_shared<MessageThread>(longRoot);
+    store.addThread(longThread);
+
+    std::shared_ptr<MessageThread> thread;
+    for (size_t i = 0; i < replyCount; ++i)
+    {
+        auto id = QString::number(i);
+
+        if (i % 2 == 0)
+        {
+            auto reply = makeMessage(id);
+            reply->replyThread = longThread;
+            longThread->addToThread(std::weak_ptr<const Message>(reply));
+            push(reply);
+            continue;
+        }
+
+        if (i % (repliesPerThread * 2) == 1)
+        {
+            // Start a new thread on the most recent message
+            auto parent = store.findMessage(QString::number(i - 1));
+            ASSERT_NE(parent, nullptr) << "i = " << i;
+            thread = std::make_shared<MessageThread>(parent);
+            store.addThread(thread);
+        }
+
+        auto reply = makeMessage(id);
+        reply->replyThread = thread;
+        thread->addToThread(std::weak_ptr<const Message>(reply));
+        push(reply);
+
+        ASSERT_LE(store.messageCount(), limit);
+        ASSERT_LE(store.threadCount(), limit);
+    }
+
+    EXPECT_LE(store.messageCount(), limit);
+    EXPECT_LE(store.threadCount(), limit);
+
+    // Everything still in the buffer can be resolved
+    for (const auto &message : buffer)
+    {
+        EXPECT_EQ(store.findMessage(message->id), message);
+    }
+
+    // Expired replies are dropped from the long-lived thread as it grows
+    EXPECT_LE(longThread->replies().size(), 2 * limit);
+
+    // Threads whose replies left the buffer were dropped with them
+    EXPECT_EQ(store.getThread(QString::number(0)), nullptr);
+}
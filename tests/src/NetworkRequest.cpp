@@ -4,10 +4,14 @@
 #include "common/NetworkResult.hpp"
 #include "common/Outcome.hpp"
 #include "common/QLogging.hpp"
+#include "debug/AssertInGuiThread.hpp"
 #include "providers/twitch/api/Helix.hpp"
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <vector>
+
 using namespace chatterino;
 
 namespace {
@@ -25,6 +29,11 @@ QString getDelayURL(int delay)
     return QString("%1/delay/%2").arg(HTTPBIN_BASE_URL).arg(delay);
 }
 
+QString getUuidURL()
+{
+    return QString("%1/uuid").arg(HTTPBIN_BASE_URL);
+}
+
 }  // namespace
 
 TEST(NetworkRequest, Success)
@@ -346,3 +355,253 @@ TEST(NetworkRequest, FinallyCallbackOnTimeout)
     EXPECT_FALSE(onSuccessCalled);
     EXPECT_TRUE(NetworkManager::workerThread.isRunning());
 }
+
+TEST(NetworkRequest, CoalesceConcurrentGets)
+{
+    EXPECT_TRUE(NetworkManager::workerThread.isRunning());
+
+    // Every transfer of /uuid returns a different body, so both callbacks
+    // receiving the same one means they shared a single transfer
+    auto url = getUuidURL();
+
+    std::mutex mut;
+    int requestsDone = 0;
+    std::condition_variable requestDoneCondition;
+    std::vector<QByteArray> bodies;
+
+    for (int i = 0; i < 2; i++)
+    {
+        NetworkRequest(url)
+            .onSuccess([&](NetworkResult result) -> Outcome {
+                EXPECT_EQ(result.status(), 200);
+
+                {
+                    std::unique_lock lck(mut);
+                    bodies.push_back(result.getData());
+                    requestsDone++;
+                }
+                requestDoneCondition.notify_one();
+                return Success;
+            })
+            .execute();
+    }
+
+    std::unique_lock lck(mut);
+    requestDoneCondition.wait(lck, [&requestsDone] {
+        return requestsDone == 2;
+    });
+
+    ASSERT_EQ(bodies.size(), 2);
+    EXPECT_FALSE(bodies[0].isEmpty());
+    EXPECT_EQ(bodies[0], bodies[1]);
+
+    EXPECT_TRUE(NetworkManager::workerThread.isRunning());
+}
+
+TEST(NetworkRequest, DontCoalesceSequentialGets)
+{
+    EXPECT_TRUE(NetworkManager::workerThread.isRunning());
+
+    auto url = getUuidURL();
+
+    std::vector<QByteArray> bodies;
+
+    for (int i = 0; i < 2; i++)
+    {
+        std::mutex mut;
+        bool requestDone = false;
+        std::condition_variable requestDoneCondition;
+
+        NetworkRequest(url)
+            .onSuccess([&](NetworkResult result) -> Outcome {
+                {
+                    std::unique_lock lck(mut);
+                    bodies.push_back(result.getData());
+                    requestDone = true;
+                }
+                requestDoneCondition.notify_one();
+                return Success;
+            })
+            .execute();
+
+        std::unique_lock lck(mut);
+        requestDoneCondition.wait(lck, [&requestDone] {
+            return requestDone;
+        });
+    }
+
+    ASSERT_EQ(bodies.size(), 2);
+    EXPECT_NE(bodies[0], bodies[1]);
+}
+
+TEST(NetworkRequest, CoalescedFinallyAndErrors)
+{
+    EXPECT_TRUE(NetworkManager::workerThread.isRunning());
+
+    auto url = getStatusURL(404);
+
+    std::mutex mut;
+    int errorsReceived = 0;
+    int finallyCalled = 0;
+    std::condition_variable requestDoneCondition;
+
+    for (int i = 0; i < 3; i++)
+    {
+        NetworkRequest(url)
+            .onSuccess([&](NetworkResult result) -> Outcome {
+                // The code should throw an error
+                EXPECT_TRUE(false);
+                return Success;
+            })
+            .onError([&](NetworkResult result) {
+                EXPECT_EQ(result.status(), 404);
+
+                std::unique_lock lck(mut);
+                errorsReceived++;
+            })
+            .finally([&] {
+                {
+                    std::unique_lock lck(mut);
+                    finallyCalled++;
+                }
+                requestDoneCondition.notify_one();
+            })
+            .execute();
+    }
+
+    std::unique_lock lck(mut);
+    requestDoneCondition.wait(lck, [&finallyCalled] {
+        return finallyCalled == 3;
+    });
+
+    EXPECT_EQ(errorsReceived, 3);
+}
+
+TEST(NetworkRequest, PriorityQueueDrains)
+{
+    EXPECT_TRUE(NetworkManager::workerThread.isRunning());
+
+    const std::vector<NetworkRequestPriority> priorities{
+        NetworkRequestPriority::Background,
+        NetworkRequestPriority::ChatCritical,
+        NetworkRequestPriority::Interactive,
+    };
+
+    // More requests than are allowed to run per host, with distinct URLs so
+    // that none of them are coalesced
+    const int requestsPerPriority = 8;
+
+    std::mutex mut;
+    int requestsDone = 0;
+    std::condition_variable requestDoneCondition;
+    // Priorities in the order the requests were started
+    std::vector<NetworkRequestPriority> started;
+
+    for (const auto priority : priorities)
+    {
+        for (int i = 0; i < requestsPerPriority; i++)
+        {
+            auto url = QString("%1/anything/%2/%3")
+                           .arg(HTTPBIN_BASE_URL)
+                           .arg(int(priority))
+                           .arg(i);
+
+            NetworkRequest(url)
+                .priority(priority)
+                .onReplyCreated([&, priority](QNetworkReply * /*reply*/) {
+                    std::unique_lock lck(mut);
+                    started.push_back(priority);
+                })
+                .onSuccess([&](NetworkResult result) -> Outcome {
+                    EXPECT_EQ(result.status(), 200);
+                    return Success;
+                })
+                .onError([&](NetworkResult result) {
+                    // The requests should *not* throw an error
+                    EXPECT_TRUE(false);
+                })
+                .finally([&] {
+                    {
+                        std::unique_lock lck(mut);
+                        requestsDone++;
+                    }
+                    requestDoneCondition.notify_one();
+                })
+                .execute();
+        }
+    }
+
+    std::unique_lock lck(mut);
+    requestDoneCondition.wait(lck, [&] {
+        return requestsDone == requestsPerPriority * int(priorities.size());
+    });
+
+    ASSERT_EQ(started.size(), requestsPerPriority * priorities.size());
+
+    auto lastStarted = [&started](NetworkRequestPriority priority) {
+        return std::find(started.rbegin(), started.rend(), priority) -
+               started.rbegin();
+    };
+
+    // The requests were submitted from the lowest to the highest priority.
+    // Once the host was busy, the queued requests must have started from the
+    // highest priority down, so the background requests started last.
+    EXPECT_GT(lastStarted(NetworkRequestPriority::ChatCritical),
+              lastStarted(NetworkRequestPriority::Background));
+    EXPECT_GT(lastStarted(NetworkRequestPriority::Interactive),
+              lastStarted(NetworkRequestPriority::ChatCritical));
+
+    EXPECT_TRUE(NetworkManager::workerThread.isRunning());
+}
+
+TEST(NetworkRequest, SuccessDecoded)
+{
+    EXPECT_TRUE(NetworkManager::workerThread.isRunning());
+
+    auto url = getStatusURL(200);
+
+    std::mutex mut;
+    bool requestDone = false;
+    std::condition_variable requestDoneCondition;
+    bool decodedOnGuiThread = true;
+    bool appliedOnGuiThread = false;
+    int appliedStatus = 0;
+    bool finallyAfterApply = false;
+
+    NetworkRequest(url)
+        .onSuccessDecoded(
+            [&](const NetworkResult &result) {
+                decodedOnGuiThread = isGuiThread();
+                return result.status();
+            },
+            [&](int &&status) {
+                appliedOnGuiThread = isGuiThread();
+                appliedStatus = status;
+            })
+        .onError([&](NetworkResult result) {
+            // The code should *not* throw an error
+            EXPECT_TRUE(false);
+        })
+        .finally([&] {
+            finallyAfterApply = appliedStatus != 0;
+
+            {
+                std::unique_lock lck(mut);
+                requestDone = true;
+            }
+            requestDoneCondition.notify_one();
+        })
+        .execute();
+
+    // Wait for the request to finish
+    std::unique_lock lck(mut);
+    requestDoneCondition.wait(lck, [&requestDone] {
+        return requestDone;
+    });
+
+    EXPECT_FALSE(decodedOnGuiThread);
+    EXPECT_TRUE(appliedOnGuiThread);
+    EXPECT_EQ(appliedStatus, 200);
+    EXPECT_TRUE(finallyAfterApply);
+    EXPECT_TRUE(NetworkManager::workerThread.isRunning());
+}
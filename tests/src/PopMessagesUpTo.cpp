@@ -0,0 +1,91 @@
+#include "widgets/helper/PopMessagesUpTo.hpp"
+
+#include "messages/Message.hpp"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+using namespace chatterino;
+
+namespace {
+
+struct FakeLayout {
+    MessagePtr message;
+
+    const MessagePtr &getMessagePtr() const
+    {
+        return this->message;
+    }
+};
+
+using FakeLayoutPtr = std::shared_ptr<FakeLayout>;
+
+std::vector<MessagePtr> makeMessages(size_t count)
+{
+    std::vector<MessagePtr> messages;
+    for (size_t i = 0; i < count; ++i)
+    {
+        messages.push_back(std::make_shared<Message>());
+    }
+    return messages;
+}
+
+std::vector<MessagePtr> messagesOf(const LimitedQueue<FakeLayoutPtr> &layouts)
+{
+    std::vector<MessagePtr> messages;
+    for (const auto &layout : layouts.getSnapshot())
+    {
+        messages.push_back(layout->message);
+    }
+    return messages;
+}
+
+}  // namespace
+
+TEST(PopMessagesUpTo, LaidOutMessage)
+{
+    auto messages = makeMessages(4);
+    LimitedQueue<FakeLayoutPtr> layouts(10);
+    LimitedQueue<MessagePtr> hidden(10);
+    for (const auto &message : messages)
+    {
+        layouts.pushBack(std::make_shared<FakeLayout>(FakeLayout{message}));
+    }
+
+    EXPECT_EQ(popMessagesUpTo(layouts, hidden, messages[1]), 2);
+    EXPECT_EQ(messagesOf(layouts),
+              (std::vector<MessagePtr>{messages[2], messages[3]}));
+}
+
+TEST(PopMessagesUpTo, HiddenMessage)
+{
+    auto messages = makeMessages(4);
+    LimitedQueue<FakeLayoutPtr> layouts(10);
+    LimitedQueue<MessagePtr> hidden(10);
+    layouts.pushBack(std::make_shared<FakeLayout>(FakeLayout{messages[0]}));
+    hidden.pushBack(messages[1]);
+    hidden.pushBack(messages[2]);
+    hidden.pushBack(messages[3]);
+
+    // Hidden messages are newer than all layouts
+    EXPECT_EQ(popMessagesUpTo(layouts, hidden, messages[2]), 1);
+    EXPECT_TRUE(layouts.empty());
+    EXPECT_EQ(hidden.getSnapshot().size(), 1);
+    EXPECT_EQ(*hidden.first(), messages[3]);
+}
+
+TEST(PopMessagesUpTo, UnknownMessage)
+{
+    auto messages = makeMessages(3);
+    LimitedQueue<FakeLayoutPtr> layouts(10);
+    LimitedQueue<MessagePtr> hidden(10);
+    layouts.pushBack(std::make_shared<FakeLayout>(FakeLayout{messages[0]}));
+    hidden.pushBack(messages[1]);
+
+    // Filtered out of the view, so there's nothing to drop
+    EXPECT_EQ(popMessagesUpTo(layouts, hidden, messages[2]), 0);
+    EXPECT_EQ(messagesOf(layouts), (std::vector<MessagePtr>{messages[0]}));
+    EXPECT_EQ(*hidden.first(), messages[1]);
+}